@@ -0,0 +1,105 @@
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// dbj::any::bag against std::vector<std::any>
+// mixed int, double and short std::string; build, visit, destroy
+#include <any>
+#include <string>
+#include <vector>
+
+#include "../dbj_any_wrapper/dbj_any_bag.h"
+#include "dbj_bench.h"
+
+using namespace dbj::bench;
+
+int main() {
+
+	constexpr auto suite_ = "any_bag";
+
+	for (std::size_t size_ : { std::size_t(1) << 10, std::size_t(1) << 16, std::size_t(1) << 20 }) {
+		char name_[96]{};
+		const std::size_t reps_ = (std::size_t(1) << 22) / size_;
+		double build_ns_ = 0, visit_ns_ = 0, destroy_ns_ = 0;
+
+		// std::vector<std::any>
+		for (std::size_t r = 0; r < reps_; ++r) {
+			auto start_ = clock_type::now();
+			auto* vec_ = new std::vector<std::any>();
+			vec_->reserve(size_);
+			for (std::size_t j = 0; j < size_; ++j) {
+				switch (j % 3) {
+				case 0: vec_->emplace_back(int(j)); break;
+				case 1: vec_->emplace_back(double(j)); break;
+				default: vec_->emplace_back(std::string("dbj any")); break;
+				}
+			}
+			build_ns_ += elapsed_ns(start_);
+
+			start_ = clock_type::now();
+			double sum_{};
+			for (auto& a_ : *vec_) {
+				if (auto* i_ = std::any_cast<int>(&a_)) sum_ += *i_;
+				else if (auto* d_ = std::any_cast<double>(&a_)) sum_ += *d_;
+				else if (auto* s_ = std::any_cast<std::string>(&a_)) sum_ += (double)s_->size();
+			}
+			do_not_optimize(sum_);
+			visit_ns_ += elapsed_ns(start_);
+
+			start_ = clock_type::now();
+			delete vec_;
+			destroy_ns_ += elapsed_ns(start_);
+		}
+		const double per_ = (double)(reps_ * size_);
+		std::snprintf(name_, sizeof(name_), "vector_any_build/%zu", size_);
+		report(suite_, name_, build_ns_ / per_, reps_ * size_);
+		std::snprintf(name_, sizeof(name_), "vector_any_visit/%zu", size_);
+		report(suite_, name_, visit_ns_ / per_, reps_ * size_);
+		std::snprintf(name_, sizeof(name_), "vector_any_destroy/%zu", size_);
+		report(suite_, name_, destroy_ns_ / per_, reps_ * size_);
+
+		// dbj::any::bag
+		build_ns_ = visit_ns_ = destroy_ns_ = 0;
+		double typed_visit_ns_ = 0;
+		for (std::size_t r = 0; r < reps_; ++r) {
+			auto start_ = clock_type::now();
+			auto* bag_ = new dbj::any::bag();
+			for (std::size_t j = 0; j < size_; ++j) {
+				switch (j % 3) {
+				case 0: bag_->emplace<int>(int(j)); break;
+				case 1: bag_->emplace<double>(double(j)); break;
+				default: bag_->emplace<std::string>("dbj any"); break;
+				}
+			}
+			build_ns_ += elapsed_ns(start_);
+
+			start_ = clock_type::now();
+			double sum_{};
+			bag_->visit_all([&](const dbj::any::bag_vtable* tag_, const void* v_) {
+				if (tag_ == dbj::any::bag_tag<int>) sum_ += *static_cast<const int*>(v_);
+				else if (tag_ == dbj::any::bag_tag<double>) sum_ += *static_cast<const double*>(v_);
+				else if (tag_ == dbj::any::bag_tag<std::string>) sum_ += (double)static_cast<const std::string*>(v_)->size();
+				});
+			do_not_optimize(sum_);
+			visit_ns_ += elapsed_ns(start_);
+
+			start_ = clock_type::now();
+			sum_ = 0;
+			bag_->visit<int>([&](int i_) { sum_ += i_; });
+			bag_->visit<double>([&](double d_) { sum_ += d_; });
+			bag_->visit<std::string>([&](const std::string& s_) { sum_ += (double)s_.size(); });
+			do_not_optimize(sum_);
+			typed_visit_ns_ += elapsed_ns(start_);
+
+			start_ = clock_type::now();
+			delete bag_;
+			destroy_ns_ += elapsed_ns(start_);
+		}
+		std::snprintf(name_, sizeof(name_), "any_bag_build/%zu", size_);
+		report(suite_, name_, build_ns_ / per_, reps_ * size_);
+		std::snprintf(name_, sizeof(name_), "any_bag_visit_all/%zu", size_);
+		report(suite_, name_, visit_ns_ / per_, reps_ * size_);
+		std::snprintf(name_, sizeof(name_), "any_bag_visit_by_type/%zu", size_);
+		report(suite_, name_, typed_visit_ns_ / per_, reps_ * size_);
+		std::snprintf(name_, sizeof(name_), "any_bag_destroy/%zu", size_);
+		report(suite_, name_, destroy_ns_ / per_, reps_ * size_);
+	}
+}
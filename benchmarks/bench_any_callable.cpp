@@ -0,0 +1,73 @@
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// calls per second: std::any based wrapper, std::function,
+// dbj::any::callable, dbj::any::function_ref and dispatch()
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "../dbj_any_wrapper/dbj_any_wrapper.h"
+#include "../dbj_any_wrapper/dbj_any_callable.h"
+#include "dbj_bench.h"
+
+using namespace dbj::bench;
+
+namespace {
+
+	constexpr std::size_t N = 1 << 22;
+
+	// one record per bench, as report() plus the rate
+	void report_calls(const char* name_, double ns_per_call_)
+	{
+		std::printf(
+			"{\"suite\":\"any_callable\",\"bench\":\"%s\",\"ns_per_op\":%.3f,\"iterations\":%zu,\"calls_per_second\":%.3f}\n",
+			name_, ns_per_call_, N, 1e9 / ns_per_call_);
+	}
+}
+
+int main() {
+
+	// shares its state, as event handlers do
+	auto sink_ = std::make_shared<long long>(0);
+	auto handler_ = [sink_](int i_) { *sink_ += i_; };
+
+	{
+		// how it was done: copy out of std::any, then invoke the copy
+		auto wrapped_ = dbj::any::wrapper<decltype(handler_)>::make(handler_);
+		int i_{ 0 };
+		report_calls("any_wrapper_get_invoke", ns_per_op(N, [&] { std::invoke(wrapped_.get(), i_++); }));
+
+		i_ = 0;
+		report_calls("any_wrapper_call", ns_per_op(N, [&] { wrapped_(i_++); }));
+	}
+	{
+		std::function<void(int)> fun_ = handler_;
+		int i_{ 0 };
+		report_calls("std_function", ns_per_op(N, [&] { fun_(i_++); }));
+	}
+	{
+		dbj::any::callable<void(int)> fun_ = handler_;
+		int i_{ 0 };
+		report_calls("dbj_callable", ns_per_op(N, [&] { fun_(i_++); }));
+	}
+	{
+		dbj::any::function_ref<void(int)> fun_ = handler_;
+		int i_{ 0 };
+		report_calls("dbj_function_ref", ns_per_op(N, [&] { fun_(i_++); }));
+	}
+	{
+		std::vector<std::function<void(int)>> funs_(1024, handler_);
+		const std::size_t rounds_ = N / funs_.size();
+		report_calls("std_function_loop/1024", ns_per_op(rounds_, [&] {
+			for (auto& f_ : funs_) f_(1);
+			}) / (double)funs_.size());
+	}
+	{
+		std::vector<dbj::any::callable<void(int)>> funs_(1024, handler_);
+		const std::size_t rounds_ = N / funs_.size();
+		report_calls("dbj_dispatch/1024", ns_per_op(rounds_, [&] {
+			dbj::any::dispatch(funs_.data(), funs_.data() + funs_.size(), 1);
+			}) / (double)funs_.size());
+	}
+	do_not_optimize(*sink_);
+}
@@ -0,0 +1,80 @@
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// dbj::any::wrapper<T> basic operations, for T kept inside std::any
+// and for T std::any puts on the heap
+// to_string() is std::to_string() thus it is measured for arithmetic
+// types only: int, and long double which does not fit the small
+// buffer of libstdc++
+#include <array>
+
+#include "../dbj_any_wrapper/dbj_any_wrapper.h"
+#include "dbj_bench.h"
+
+using namespace dbj::bench;
+
+namespace {
+
+	constexpr std::size_t iterations_ = 1 << 20;
+
+	struct large final {
+		std::array<char, 256> payload{};
+	};
+
+	template <typename T>
+	void bench_wrapper(const char* suite_, const char* type_, T val_)
+	{
+		using wrapper = dbj::any::wrapper<T>;
+		char name_[128]{};
+		wrapper w_{ val_ };
+
+		snprintf(name_, sizeof(name_), "construct/%s", type_);
+		report(suite_, name_, ns_per_op(iterations_, [&] {
+			wrapper fresh_{ val_ };
+			do_not_optimize(fresh_);
+			}), iterations_);
+
+		snprintf(name_, sizeof(name_), "copy/%s", type_);
+		report(suite_, name_, ns_per_op(iterations_, [&] {
+			wrapper copy_{ w_ };
+			do_not_optimize(copy_);
+			}), iterations_);
+
+		snprintf(name_, sizeof(name_), "move/%s", type_);
+		report(suite_, name_, ns_per_op(iterations_, [&] {
+			wrapper moved_{ std::move(w_) };
+			w_ = std::move(moved_);
+			do_not_optimize(w_);
+			}), iterations_);
+
+		snprintf(name_, sizeof(name_), "get/%s", type_);
+		report(suite_, name_, ns_per_op(iterations_, [&] {
+			do_not_optimize(w_.get());
+			}), iterations_);
+	}
+
+	template <typename T>
+	void bench_to_string(const char* suite_, const char* type_, T val_)
+	{
+		char name_[128]{};
+		dbj::any::wrapper<T> w_{ val_ };
+		snprintf(name_, sizeof(name_), "to_string/%s", type_);
+		report(suite_, name_, ns_per_op(iterations_, [&] {
+			do_not_optimize(w_.to_string());
+			}), iterations_);
+	}
+}
+
+int main() {
+
+	constexpr auto suite_ = "any_wrapper";
+
+	report_value(suite_, "heap/int", "flag", dbj::any::details::any_allocates<int>);
+	report_value(suite_, "heap/large", "flag", dbj::any::details::any_allocates<large>);
+	report_value(suite_, "heap/long_double", "flag", dbj::any::details::any_allocates<long double>);
+
+	bench_wrapper(suite_, "int", 42);
+	bench_wrapper(suite_, "large", large{});
+
+	bench_to_string(suite_, "int", 42);
+	bench_to_string(suite_, "long_double", 42.0L);
+}
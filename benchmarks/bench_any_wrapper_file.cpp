@@ -0,0 +1,86 @@
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// open to first element, and a full scan, of a file of wrapped
+// trivially copyable values: mapped_range against reading the
+// whole file back into wrappers with fread
+#include <cstdio>
+#include <vector>
+
+#include "../dbj_any_wrapper/dbj_any_wrapper_file.h"
+#include "dbj_bench.h"
+
+using namespace dbj::bench;
+
+namespace {
+
+	struct point final { double x, y, z; };
+
+	constexpr std::size_t count_ = 1 << 20;
+	constexpr const char* path_ = "bench_any_wrapper_file.bin";
+
+	// what a deserializing reader does: every element becomes a wrapper again
+	std::vector<dbj::any::wrapper<point>> read_back()
+	{
+		std::vector<dbj::any::wrapper<point>> result_{};
+		FILE* fp_ = std::fopen(path_, "rb");
+		if (!fp_) return result_;
+		dbj::any::file_header h_{};
+		if (std::fread(&h_, sizeof(h_), 1, fp_) == 1) {
+			std::vector<unsigned char> bits_((std::size_t(h_.count) + 7) / 8);
+			std::vector<point> data_(std::size_t(h_.count));
+			std::fread(bits_.data(), 1, bits_.size(), fp_);
+			std::fseek(fp_, long(h_.data_offset), SEEK_SET);
+			std::fread(data_.data(), sizeof(point), data_.size(), fp_);
+			result_.reserve(data_.size());
+			for (std::size_t j = 0; j < data_.size(); ++j)
+				result_.push_back((bits_[j / 8] >> (j % 8)) & 1
+					? dbj::any::wrapper<point>(data_[j]) : dbj::any::wrapper<point>{});
+		}
+		std::fclose(fp_);
+		return result_;
+	}
+}
+
+int main() {
+
+	constexpr auto suite_ = "any_wrapper_file";
+
+	{
+		std::vector<dbj::any::wrapper<point>> src_{};
+		src_.reserve(count_);
+		for (std::size_t j = 0; j < count_; ++j)
+			src_.push_back(j % 16 ? dbj::any::wrapper<point>(point{ double(j), 1, 2 }) : dbj::any::wrapper<point>{});
+
+		auto start_ = clock_type::now();
+		dbj::any::write_range(path_, src_);
+		report(suite_, "write_range", elapsed_ns(start_) / count_, count_);
+	}
+
+	report(suite_, "mapped_range/open_first", ns_per_op(100, [] {
+		dbj::any::mapped_range<point> mapped_(path_);
+		do_not_optimize(mapped_[1].get().x);
+		}), 100);
+
+	report(suite_, "fread/open_first", ns_per_op(5, [] {
+		auto wrappers_ = read_back();
+		do_not_optimize(wrappers_[1].get().x);
+		}), 5);
+
+	dbj::any::mapped_range<point> mapped_(path_);
+	report(suite_, "mapped_range/scan", ns_per_op(10, [&] {
+		double sum_{};
+		for (std::size_t j = 0; j < mapped_.size(); ++j)
+			if (!mapped_.empty(j)) sum_ += mapped_.data()[j].x;
+		do_not_optimize(sum_);
+		}) / count_, 10 * count_);
+
+	auto wrappers_ = read_back();
+	report(suite_, "any_wrapper/scan", ns_per_op(10, [&] {
+		double sum_{};
+		for (auto& w_ : wrappers_)
+			if (!w_.empty()) sum_ += w_.get().x;
+		do_not_optimize(sum_);
+		}) / count_, 10 * count_);
+
+	std::remove(path_);
+}
@@ -0,0 +1,60 @@
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// per request build and teardown of wrapped values
+// std::any based wrapper on the global heap against pmr::wrapper
+// on the global heap and on a monotonic arena released in one shot
+#include <memory_resource>
+#include <string>
+
+#include "../dbj_any_wrapper/dbj_any_wrapper_pmr.h"
+#include "dbj_bench.h"
+
+using namespace dbj::bench;
+
+namespace {
+
+	constexpr std::size_t requests_ = 20000;
+
+	// one "request" worth of data
+	int ints_[64]{};
+	std::string strings_[16]{};
+	std::pmr::string pmr_strings_[16]{};
+}
+
+int main() {
+
+	constexpr auto suite_ = "any_wrapper_pmr";
+
+	for (int j = 0; j < 64; ++j) ints_[j] = j;
+	for (int j = 0; j < 16; ++j) {
+		strings_[j] = "request payload longer than the small string buffer";
+		pmr_strings_[j] = "request payload longer than the small string buffer";
+	}
+
+	report(suite_, "any_wrapper/global_heap", ns_per_op(requests_, [] {
+		auto ints_w_ = dbj::any::wrapper_range(ints_);
+		auto strings_w_ = dbj::any::wrapper_range(strings_);
+		do_not_optimize(ints_w_);
+		do_not_optimize(strings_w_);
+		}), requests_);
+
+	report(suite_, "pmr_wrapper/new_delete_resource", ns_per_op(requests_, [] {
+		auto* mr_ = std::pmr::new_delete_resource();
+		auto ints_w_ = dbj::any::pmr::wrapper_range(ints_, mr_);
+		auto strings_w_ = dbj::any::pmr::wrapper_range(pmr_strings_, mr_);
+		do_not_optimize(ints_w_);
+		do_not_optimize(strings_w_);
+		}), requests_);
+
+	report(suite_, "pmr_wrapper/monotonic_buffer_resource", ns_per_op(requests_, [] {
+		alignas(std::max_align_t) std::byte buffer_[8 * 1024];
+		std::pmr::monotonic_buffer_resource arena_{ buffer_, sizeof(buffer_) };
+		{
+			auto ints_w_ = dbj::any::pmr::wrapper_range(ints_, &arena_);
+			auto strings_w_ = dbj::any::pmr::wrapper_range(pmr_strings_, &arena_);
+			do_not_optimize(ints_w_);
+			do_not_optimize(strings_w_);
+		}
+		// everything goes in one shot
+		}), requests_);
+}
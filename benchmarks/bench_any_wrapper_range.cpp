@@ -0,0 +1,55 @@
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// wrapper_range() of T[N] into std::array<wrapper<T>,N>, at several N
+// and literal_range() of the same, made at runtime for comparison
+#include <utility>
+
+#include "../dbj_any_wrapper/dbj_any_wrapper.h"
+#include "dbj_bench.h"
+
+using namespace dbj::bench;
+
+namespace {
+
+	template <std::size_t N>
+	void bench_range(const char* suite_)
+	{
+		static int source_[N]{};
+		for (std::size_t j = 0; j < N; ++j) source_[j] = int(j);
+
+		const std::size_t iterations_ = (1 << 22) / N;
+		char name_[128]{};
+
+		snprintf(name_, sizeof(name_), "wrapper_range/N:%zu", N);
+		report(suite_, name_, ns_per_op(iterations_, [] {
+			auto range_ = dbj::any::wrapper_range(source_);
+			do_not_optimize(range_);
+			}), iterations_);
+
+		snprintf(name_, sizeof(name_), "literal_range/N:%zu", N);
+		report(suite_, name_, ns_per_op(iterations_, [] {
+			auto range_ = dbj::any::literal_range(source_);
+			do_not_optimize(range_);
+			}), iterations_);
+
+		// sum through the wrappers, per element
+		static auto range_ = dbj::any::wrapper_range(source_);
+		snprintf(name_, sizeof(name_), "wrapper_range_scan/N:%zu", N);
+		report(suite_, name_, ns_per_op(iterations_, [] {
+			long long sum_{};
+			for (auto& w_ : range_) sum_ += w_.get();
+			do_not_optimize(sum_);
+			}) / N, iterations_ * N);
+	}
+
+	template <std::size_t... N>
+	void bench_ranges(const char* suite_, std::index_sequence<N...>)
+	{
+		(bench_range<N>(suite_), ...);
+	}
+}
+
+int main() {
+
+	bench_ranges("any_wrapper_range", std::index_sequence<1, 16, 256, 4096>{});
+}
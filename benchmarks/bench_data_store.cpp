@@ -0,0 +1,70 @@
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// dbj::data read() and store() under each LOCK policy,
+// from one thread and from many at once
+#include <thread>
+#include <vector>
+
+#include "../dbj_nifty_store.h"
+#include "dbj_bench.h"
+
+using namespace dbj::bench;
+
+namespace {
+
+	constexpr std::size_t iterations_ = 1 << 20;
+
+	constexpr dbj::GUID store_id() {
+		using namespace dbj::literals;
+		return "{9A4C2B71-5E3D-4F86-A0C9-7B1E2D3F4A55}"_guid;
+	}
+
+	using nolock_store = dbj::data<int, store_id, dbj::nolock>;
+	using padlock_store = dbj::data<int, store_id, dbj::padlock>;
+
+	template <typename STORE>
+	void bench_store(const char* suite_, const char* lock_)
+	{
+		char name_[128]{};
+		int val_ = 42;
+
+		snprintf(name_, sizeof(name_), "store/%s", lock_);
+		report(suite_, name_, ns_per_op(iterations_, [&] {
+			do_not_optimize(STORE::store(val_));
+			}), iterations_);
+
+		snprintf(name_, sizeof(name_), "read/%s", lock_);
+		report(suite_, name_, ns_per_op(iterations_, [] {
+			do_not_optimize(STORE::read());
+			}), iterations_);
+
+		// one writer, the rest read; nolock is not safe with
+		// a writer, thus for it everyone reads
+		const unsigned hw_ = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 2;
+		const unsigned threads_ = hw_ < 2 ? 2 : hw_;
+		constexpr bool locking_ = std::is_same_v<typename STORE::lock_type, dbj::padlock>;
+
+		std::vector<std::thread> workers_;
+		auto start_ = clock_type::now();
+		for (unsigned t = 0; t < threads_; ++t)
+			workers_.emplace_back([t] {
+			int v_ = int(t);
+			for (std::size_t j = 0; j < iterations_; ++j) {
+				if (locking_ && t == 0) do_not_optimize(STORE::store(v_));
+				else do_not_optimize(STORE::read());
+			}
+				});
+		for (auto& w_ : workers_) w_.join();
+
+		snprintf(name_, sizeof(name_), "read_store/%s/threads:%u", lock_, threads_);
+		report(suite_, name_, elapsed_ns(start_) / (double(iterations_) * threads_), iterations_ * threads_);
+	}
+}
+
+int main() {
+
+	constexpr auto suite_ = "data_store";
+
+	bench_store<nolock_store>(suite_, "nolock");
+	bench_store<padlock_store>(suite_, "padlock");
+}
@@ -0,0 +1,74 @@
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// _guid parsing of strings known only at runtime, and uuid4_guid()
+// from the shared generator, on one thread as it is not thread safe;
+// throughput on 1, 2, 4 ... hardware concurrency threads is measured
+// with a generator state per thread
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../dbj_guid/dbj_guid.h"
+#include "dbj_bench.h"
+
+using namespace dbj::bench;
+
+namespace {
+
+	constexpr std::size_t per_thread_ = 1 << 18;
+
+	// GUIDs per second, all threads together
+	template <typename F>
+	double throughput(unsigned threads_, F make_guid_)
+	{
+		std::vector<std::thread> workers_;
+		auto start_ = clock_type::now();
+		for (unsigned t = 0; t < threads_; ++t)
+			workers_.emplace_back([&] {
+			for (std::size_t j = 0; j < per_thread_; ++j)
+				do_not_optimize(make_guid_());
+				});
+		for (auto& w_ : workers_) w_.join();
+		return double(per_thread_) * threads_ / (elapsed_ns(start_) / 1e9);
+	}
+}
+
+int main() {
+
+	constexpr auto suite_ = "guid";
+
+	// strings the compiler can not see through
+	std::vector<std::string> texts_{};
+	for (int j = 0; j < 64; ++j) {
+		char buf_[64]{};
+		snprintf(buf_, sizeof(buf_), "{%08X-BAA5-407F-BB47-F78752D2C2%02X}", 0xFE297330u + j, j);
+		texts_.push_back(buf_);
+	}
+
+	constexpr std::size_t parses_ = 1 << 20;
+	std::size_t next_{ 0 };
+	report(suite_, "_guid/runtime_parse", ns_per_op(parses_, [&] {
+		const std::string& s_ = texts_[next_++ & 63];
+		do_not_optimize(dbj::literals::operator""_guid(s_.c_str(), s_.size()));
+		}), parses_);
+
+	report(suite_, "uuid4_guid", ns_per_op(per_thread_, [] {
+		do_not_optimize(uuid4_guid());
+		}), per_thread_);
+
+	const unsigned hw_ = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+	std::vector<unsigned> thread_counts_{ 1u, 2u, 4u };
+	if (hw_ > 4) thread_counts_.push_back(hw_);
+	char name_[64]{};
+
+	for (unsigned threads_ : thread_counts_) {
+		snprintf(name_, sizeof(name_), "uuid4_guid_own_state/threads:%u", threads_);
+		report_value(suite_, name_, "guids_per_second",
+			throughput(threads_, [] {
+				thread_local uint64_t state_[2]{};
+				thread_local bool seeded_ = (uuid4_seed_state(state_), true);
+				(void)seeded_;
+				return uuid4_guid(state_);
+				}));
+	}
+}
@@ -0,0 +1,118 @@
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// bulk GUID algorithms against the std:: ones driven by dbj::equal
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "../dbj_guid/dbj_guid_algo.h"
+#include "dbj_bench.h"
+
+using namespace dbj::bench;
+
+namespace {
+
+	// what one has to write without dbj_guid_algo.h
+	bool fieldwise_less(const dbj::GUID& l_, const dbj::GUID& r_)
+	{
+		if (l_.Data1 != r_.Data1) return l_.Data1 < r_.Data1;
+		if (l_.Data2 != r_.Data2) return l_.Data2 < r_.Data2;
+		if (l_.Data3 != r_.Data3) return l_.Data3 < r_.Data3;
+		for (int j = 0; j < 8; ++j)
+			if (l_.Data4[j] != r_.Data4[j]) return l_.Data4[j] < r_.Data4[j];
+		return false;
+	}
+
+	// best of a few runs, ns per element
+	template <typename F>
+	double per_element(std::vector<dbj::GUID> const& input_, F&& fun_)
+	{
+		double best_ns_ = 0;
+		std::vector<dbj::GUID> work_;
+		for (int run_ = 0; run_ < 5; ++run_) {
+			work_ = input_;
+			auto start_ = clock_type::now();
+			fun_(work_);
+			double ns_ = elapsed_ns(start_) / (double)input_.size();
+			do_not_optimize(work_.data());
+			if (run_ == 0 || ns_ < best_ns_) best_ns_ = ns_;
+		}
+		return best_ns_;
+	}
+}
+
+int main() {
+
+	constexpr auto suite_ = "guid_algo";
+	const unsigned hw_ = std::max(1u, std::thread::hardware_concurrency());
+
+	for (std::size_t size_ : { std::size_t(1) << 10, std::size_t(1) << 16, std::size_t(1) << 20, std::size_t(1) << 22 }) {
+		char name_[96]{};
+
+		// every 4th is a duplicate
+		std::vector<dbj::GUID> input_(size_);
+		for (std::size_t j = 0; j < size_; ++j)
+			input_[j] = (j % 4 == 3) ? input_[j / 2] : uuid4_guid();
+
+		const dbj::GUID absent_ = uuid4_guid();
+		const dbj::GUID* begin_ = input_.data();
+		const dbj::GUID* end_ = begin_ + size_;
+
+		std::snprintf(name_, sizeof(name_), "dbj_find/%zu", size_);
+		report(suite_, name_, per_element(input_, [&](auto&) { do_not_optimize(dbj::find(begin_, end_, absent_)); }), size_);
+
+		std::snprintf(name_, sizeof(name_), "std_find_if_equal/%zu", size_);
+		report(suite_, name_, per_element(input_, [&](auto&) {
+			do_not_optimize(std::find_if(begin_, end_, [&](auto const& g_) { return dbj::equal(g_, absent_); }));
+			}), size_);
+
+		std::snprintf(name_, sizeof(name_), "dbj_count/%zu", size_);
+		report(suite_, name_, per_element(input_, [&](auto&) { do_not_optimize(dbj::count(begin_, end_, input_[0])); }), size_);
+
+		std::snprintf(name_, sizeof(name_), "std_count_if_equal/%zu", size_);
+		report(suite_, name_, per_element(input_, [&](auto&) {
+			do_not_optimize(std::count_if(begin_, end_, [&](auto const& g_) { return dbj::equal(g_, input_[0]); }));
+			}), size_);
+
+		std::snprintf(name_, sizeof(name_), "dbj_sort/%zu", size_);
+		report(suite_, name_, per_element(input_, [](auto& v_) { dbj::sort(v_.data(), v_.data() + v_.size()); }), size_);
+
+		std::snprintf(name_, sizeof(name_), "dbj_sort/threads:%u/%zu", hw_, size_);
+		report(suite_, name_, per_element(input_, [&](auto& v_) { dbj::sort(v_.data(), v_.data() + v_.size(), hw_); }), size_);
+
+		std::snprintf(name_, sizeof(name_), "std_sort_comparator/%zu", size_);
+		report(suite_, name_, per_element(input_, [](auto& v_) { std::sort(v_.begin(), v_.end(), fieldwise_less); }), size_);
+
+		std::vector<dbj::GUID> sorted_(input_);
+		dbj::sort(sorted_.data(), sorted_.data() + sorted_.size());
+
+		std::snprintf(name_, sizeof(name_), "dbj_unique/%zu", size_);
+		report(suite_, name_, per_element(sorted_, [](auto& v_) { do_not_optimize(dbj::unique(v_.data(), v_.data() + v_.size())); }), size_);
+
+		std::snprintf(name_, sizeof(name_), "std_unique_equal/%zu", size_);
+		report(suite_, name_, per_element(sorted_, [](auto& v_) {
+			do_not_optimize(std::unique(v_.begin(), v_.end(), [](auto const& l_, auto const& r_) { return dbj::equal(l_, r_); }));
+			}), size_);
+
+		// half of the second range is shared with the first
+		std::vector<dbj::GUID> other_(sorted_.begin(), sorted_.begin() + size_ / 2);
+		for (std::size_t j = 0; j < size_ / 2; ++j) other_.push_back(uuid4_guid());
+		dbj::sort(other_.data(), other_.data() + other_.size());
+		std::vector<dbj::GUID> out_(size_);
+
+		std::snprintf(name_, sizeof(name_), "dbj_set_intersection/%zu", size_);
+		report(suite_, name_, per_element(sorted_, [&](auto& v_) {
+			do_not_optimize(dbj::set_intersection(v_.data(), v_.data() + v_.size(), other_.data(), other_.data() + other_.size(), out_.data()));
+			}), size_);
+
+		std::snprintf(name_, sizeof(name_), "std_set_intersection_comparator/%zu", size_);
+		report(suite_, name_, per_element(sorted_, [&](auto& v_) {
+			do_not_optimize(std::set_intersection(v_.begin(), v_.end(), other_.begin(), other_.end(), out_.begin(), fieldwise_less));
+			}), size_);
+
+		std::snprintf(name_, sizeof(name_), "dbj_set_difference/%zu", size_);
+		report(suite_, name_, per_element(sorted_, [&](auto& v_) {
+			do_not_optimize(dbj::set_difference(v_.data(), v_.data() + v_.size(), other_.data(), other_.data() + other_.size(), out_.data()));
+			}), size_);
+	}
+}
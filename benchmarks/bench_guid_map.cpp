@@ -0,0 +1,80 @@
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// compile time GUID map lookup against the chain of == it replaces
+#include <iterator>
+#include <vector>
+
+#include "../dbj_guid/dbj_guid_map.h"
+#include "dbj_bench.h"
+
+using namespace dbj::bench;
+using namespace dbj::literals;
+
+namespace {
+
+	constexpr dbj::GUID interface_ids_[]{
+		"{184AB52E-03C9-4EA2-891A-0578F7A87213}"_guid,
+		"{D7AB9776-64CB-4142-87E8-B51CB03BFB38}"_guid,
+		"{C5C48A85-E288-4448-9AD4-06D455F43DEE}"_guid,
+		"{C3193A5E-E5B9-4453-B5D0-FEA8049EDF04}"_guid,
+		"{A825683B-9C3C-4B18-A28F-BE76CC99A9D6}"_guid,
+		"{8EF40DED-B0D1-44C7-8AD8-F4611937B053}"_guid,
+		"{C5E077B9-0279-4902-8EE5-513B06BDD5C7}"_guid,
+		"{248A2F65-C6FD-4E6E-9EF7-2071B3035012}"_guid,
+		"{565AAF17-24C7-4E0E-B5E4-6CCDFB6382E4}"_guid,
+		"{5F6E41A4-95FE-4B13-99E8-2036ADCC939B}"_guid,
+		"{D1EF41DE-8FC2-49DB-8FBE-84F201F16A01}"_guid,
+		"{7A04A847-4242-46CB-9BC3-07C3F590BDD2}"_guid,
+		"{4CB568B2-969A-44AE-89DF-24A9B36BEF61}"_guid,
+		"{061A9238-6A9F-4BA2-8360-47B74DC709D2}"_guid,
+		"{2D32F588-082D-47DB-906D-83DA4FE6B2DB}"_guid,
+		"{F095D248-1BD4-4E51-B5AD-3A68EE1FA6D9}"_guid,
+		"{F77CC810-F0B1-4C68-BD9A-53EB6D1042F6}"_guid,
+		"{59F29E47-8BBC-4223-B87B-2837B25032BA}"_guid,
+		"{8A6FEF10-64D6-4A92-91C9-35A951970040}"_guid,
+		"{7C462EBD-8D8F-4FA9-8B01-C4DAED15A983}"_guid,
+		"{B3F002F5-3A33-4F26-A5EA-F71E5C8D8506}"_guid,
+		"{9788DC61-B28B-43BC-B32B-2B89D8CEE3DE}"_guid,
+		"{BD744799-96E6-40B6-A7C1-D081D16A29AA}"_guid,
+		"{2D6D6BCC-BE77-46D7-9862-26D22DECD86B}"_guid,
+		"{947F19E9-5A7C-42B6-AC2D-30D9C5F79508}"_guid,
+		"{89DA3A69-C448-4678-A1FC-9830851F8994}"_guid,
+		"{12F1D6C6-0080-4375-BEC7-783FEA006D10}"_guid,
+		"{77D3B92C-87D4-4066-97AD-EE7CB7B382DD}"_guid,
+		"{46F1498A-B36D-481F-9608-447BD8F5904D}"_guid,
+		"{FFF8A837-9F48-429F-8F92-16295EF18CE1}"_guid,
+		"{6972514E-B5A1-4162-B7E5-4A8A48EB618A}"_guid,
+		"{CBA147A8-A964-4141-8AFE-F2341E07DD7F}"_guid
+	};
+
+	constexpr auto ids_map_ = dbj::make_guid_map(interface_ids_);
+
+	// what one has to write without dbj_guid_map.h
+	std::size_t linear_find(const dbj::GUID& guid_)
+	{
+		for (std::size_t j = 0; j < std::size(interface_ids_); ++j)
+			if (interface_ids_[j] == guid_) return j;
+		return ids_map_.npos;
+	}
+}
+
+int main() {
+
+	constexpr auto suite_ = "guid_map";
+	constexpr std::size_t N = 1 << 20;
+
+	// half hits, half misses
+	std::vector<dbj::GUID> queries_(1024);
+	for (std::size_t j = 0; j < queries_.size(); ++j)
+		queries_[j] = (j % 2) ? interface_ids_[j % std::size(interface_ids_)] : uuid4_guid();
+
+	std::size_t q_{ 0 };
+	report(suite_, "guid_map_find/32", ns_per_op(N, [&] {
+		do_not_optimize(ids_map_.find(queries_[q_++ & 1023]));
+		}), N);
+
+	q_ = 0;
+	report(suite_, "linear_equal_find/32", ns_per_op(N, [&] {
+		do_not_optimize(linear_find(queries_[q_++ & 1023]));
+		}), N);
+}
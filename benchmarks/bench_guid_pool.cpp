@@ -0,0 +1,74 @@
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// GUID acquisition latency, p50 / p99 / p999, under contention
+// each sample is the time of a small burst divided by the burst size
+// thus the clock cost does not dominate a few nano seconds operation
+#include <thread>
+#include <vector>
+
+#include "../dbj_guid/dbj_guid_pool.h"
+#include "dbj_bench.h"
+
+using namespace dbj::bench;
+
+namespace {
+
+	constexpr std::size_t burst_ = 16;
+	constexpr std::size_t samples_per_thread_ = 20000;
+
+	template <typename F>
+	std::vector<double> sample_on_threads(unsigned threads_, F get_guid_)
+	{
+		std::vector<std::vector<double>> per_thread_(threads_);
+		std::vector<std::thread> workers_;
+
+		for (unsigned t = 0; t < threads_; ++t) {
+			workers_.emplace_back([&, t] {
+				auto& samples_ = per_thread_[t];
+				samples_.reserve(samples_per_thread_);
+				for (std::size_t s = 0; s < samples_per_thread_; ++s) {
+					auto start_ = clock_type::now();
+					for (std::size_t b = 0; b < burst_; ++b)
+						do_not_optimize(get_guid_());
+					samples_.push_back(elapsed_ns(start_) / burst_);
+				}
+				});
+		}
+		for (auto& w : workers_) w.join();
+
+		std::vector<double> all_;
+		for (auto& v : per_thread_) all_.insert(all_.end(), v.begin(), v.end());
+		return all_;
+	}
+}
+
+int main() {
+
+	constexpr auto suite_ = "guid_pool";
+	const unsigned hw_ = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+
+	{
+		auto samples_ = sample_on_threads(1, [] { return uuid4_guid(); });
+		report_latency(suite_, "uuid4_guid/threads:1", samples_);
+	}
+
+	std::vector<unsigned> thread_counts_{ 1u, 2u, 4u };
+	if (hw_ > 4) thread_counts_.push_back(hw_);
+
+	for (unsigned threads_ : thread_counts_) {
+		char name_[64]{};
+
+		// large enough not to run dry in the steady state
+		dbj::guid_pool<1 << 16> pool_{};
+		while (pool_.size() < pool_.capacity / 2)
+			std::this_thread::yield();
+
+		auto pool_samples_ = sample_on_threads(threads_, [&] { return pool_.acquire(); });
+		std::snprintf(name_, sizeof(name_), "guid_pool_acquire/threads:%u", threads_);
+		report_latency(suite_, name_, pool_samples_);
+
+		auto local_samples_ = sample_on_threads(threads_, [] { return dbj::local_guid(); });
+		std::snprintf(name_, sizeof(name_), "local_guid/threads:%u", threads_);
+		report_latency(suite_, name_, local_samples_);
+	}
+}
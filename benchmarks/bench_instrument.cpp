@@ -0,0 +1,72 @@
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// cost of one instrumented event, compare with the same
+// benchmarks built without DBJ_INSTRUMENT
+#ifndef DBJ_INSTRUMENT
+#define DBJ_INSTRUMENT 1
+#endif
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../dbj_any_wrapper/dbj_any_wrapper.h"
+#include "../dbj_nifty_store.h"
+#include "dbj_bench.h"
+
+using namespace dbj::bench;
+
+namespace {
+	constexpr std::size_t iterations_ = 1 << 22;
+
+	constexpr dbj::GUID bench_store_id() {
+		using namespace dbj::literals;
+		return "{3C1B6A2E-94D7-4F0B-8E25-6A1D9C4B7F30}"_guid;
+	}
+	using locked_store = dbj::data<int, bench_store_id, dbj::padlock>;
+}
+
+int main() {
+
+	constexpr auto suite_ = DBJ_INSTRUMENT ? "instrument/enabled" : "instrument/disabled";
+
+	report(suite_, "event", ns_per_op(iterations_, [] {
+		DBJ_INSTRUMENT_EVENT(wrapper_copy);
+		}), iterations_);
+
+	dbj::any::wrapper<int> small_{ 42 };
+	report(suite_, "wrapper<int>/copy", ns_per_op(iterations_, [&] {
+		dbj::any::wrapper<int> copy_{ small_ };
+		do_not_optimize(copy_);
+		}), iterations_);
+
+	report(suite_, "wrapper<int>/get", ns_per_op(iterations_, [&] {
+		do_not_optimize(small_.get());
+		}), iterations_);
+
+	int val_ = 13;
+	report(suite_, "data<padlock>/store", ns_per_op(iterations_, [&] {
+		do_not_optimize(locked_store::store(val_));
+		}), iterations_);
+
+	report(suite_, "uuid4_guid", ns_per_op(iterations_ / 16, [] {
+		do_not_optimize(uuid4_guid());
+		}), iterations_ / 16);
+
+	// per thread counters, no cache line ping pong
+	const unsigned threads_ = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 2;
+	auto start_ = clock_type::now();
+	{
+		std::vector<std::thread> pool_{};
+		for (unsigned t = 0; t < threads_; ++t)
+			pool_.emplace_back([] {
+			for (std::size_t j = 0; j < iterations_; ++j)
+				DBJ_INSTRUMENT_EVENT(wrapper_move);
+				});
+		for (auto& t : pool_) t.join();
+	}
+	report(suite_, "event/all_threads", elapsed_ns(start_) / iterations_, iterations_ * threads_);
+
+	// not a result, to stderr thus not in bench_results.jsonl
+	dbj::instrument::print_json(stderr, dbj::instrument::take_snapshot());
+}
@@ -0,0 +1,42 @@
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// uuid4 seeding cost
+// including dbj_guid.h must not cost anything at startup
+// seeding happens once, on the first GUID requested
+#include "../dbj_guid/dbj_guid.h"
+#include "dbj_bench.h"
+
+using namespace dbj::bench;
+
+int main() {
+
+	constexpr auto suite_ = "uuid4_startup";
+
+	// nothing has been read from the OS random source before this point
+	const int seeded_at_startup_ = uuid4_is_seeded();
+	report_value(suite_, "seeded_before_main", "flag", seeded_at_startup_);
+	// not an assert, benchmarks are built without them
+	if (seeded_at_startup_ != 0) {
+		fprintf(stderr, "\n%s -- uuid4 was seeded before the first GUID was asked for\n", __FILE__);
+		return 1;
+	}
+
+	// first call pays the seeding
+	auto start_ = clock_type::now();
+	dbj::GUID first_ = uuid4_guid();
+	report(suite_, "first_uuid4_guid", elapsed_ns(start_), 1);
+	do_not_optimize(first_);
+
+	report_value(suite_, "seeded_after_first", "flag", uuid4_is_seeded());
+
+	// every other call does not
+	constexpr std::size_t N = 100000;
+	report(suite_, "next_uuid4_guid", ns_per_op(N, [] {
+		do_not_optimize(uuid4_guid());
+		}), N);
+
+	// explicit init after the fact is a no op
+	report(suite_, "uuid4_init_after_seed", ns_per_op(N, [] {
+		do_not_optimize(uuid4_init());
+		}), N);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// dbj bench -- the smallest possible micro benchmarking kit
+// each result is one JSON object on one line, on stdout
+// thus the output can be collected and compared between releases
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+#include <vector>
+
+namespace dbj::bench {
+
+	using clock_type = std::chrono::steady_clock;
+
+	// keep the optimizer from removing the value
+	template <typename T>
+	inline void do_not_optimize(T const& val_) noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(val_) : "memory");
+#else
+		static volatile const void* sink_{};
+		sink_ = &val_;
+#endif
+	}
+
+	inline double elapsed_ns(clock_type::time_point start_) noexcept
+	{
+		return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			clock_type::now() - start_).count();
+	}
+
+	// calls fun_ N times, returns nano seconds per call
+	template <typename F>
+	inline double ns_per_op(std::size_t iterations_, F&& fun_)
+	{
+		auto start_ = clock_type::now();
+		for (std::size_t j = 0; j < iterations_; ++j)
+			fun_();
+		return elapsed_ns(start_) / (double)(iterations_ ? iterations_ : 1);
+	}
+
+	// machine readable, one line per result
+	inline void report(const char* suite_, const char* name_, double ns_per_op_, std::size_t iterations_) noexcept
+	{
+		std::printf(
+			"{\"suite\":\"%s\",\"bench\":\"%s\",\"ns_per_op\":%.3f,\"iterations\":%zu}\n",
+			suite_, name_, ns_per_op_, iterations_);
+	}
+
+	// for results that are not "per op", e.g. percentiles or counters
+	inline void report_value(const char* suite_, const char* name_, const char* unit_, double value_) noexcept
+	{
+		std::printf(
+			"{\"suite\":\"%s\",\"bench\":\"%s\",\"%s\":%.3f}\n",
+			suite_, name_, unit_, value_);
+	}
+
+	// p-th percentile, 0.0 .. 1.0, of the samples; sorts them
+	inline double percentile(std::vector<double>& samples_, double p_)
+	{
+		if (samples_.empty()) return 0;
+		std::sort(samples_.begin(), samples_.end());
+		const std::size_t at_ = (std::size_t)(p_ * (double)(samples_.size() - 1));
+		return samples_[at_];
+	}
+
+	// p50 / p99 / p999 lines for the samples
+	inline void report_latency(const char* suite_, const char* name_, std::vector<double>& samples_) noexcept
+	{
+		std::sort(samples_.begin(), samples_.end());
+		std::printf(
+			"{\"suite\":\"%s\",\"bench\":\"%s\",\"p50_ns\":%.3f,\"p99_ns\":%.3f,\"p999_ns\":%.3f,\"samples\":%zu}\n",
+			suite_, name_,
+			percentile(samples_, 0.5), percentile(samples_, 0.99), percentile(samples_, 0.999),
+			samples_.size());
+	}
+} // dbj::bench
@@ -0,0 +1,47 @@
+# (c) 2021 by dbj@dbj.org CC BY SA 4.0
+#
+# cmake -DBENCHMARKS=a,b -DOUTPUT=file.jsonl [-DSOURCE_DIR=..] -P run_benchmarks.cmake
+#
+# first line of the output tells what was measured, for comparing
+# releases; then the JSON lines of every benchmark, as they printed them
+
+string(REPLACE "," ";" BENCHMARKS "${BENCHMARKS}")
+
+string(TIMESTAMP when_ "%Y-%m-%dT%H:%M:%SZ" UTC)
+
+set(revision_ "unknown")
+find_package(Git QUIET)
+if(GIT_FOUND AND SOURCE_DIR)
+	execute_process(COMMAND ${GIT_EXECUTABLE} describe --always --dirty
+		WORKING_DIRECTORY ${SOURCE_DIR}
+		OUTPUT_VARIABLE revision_ OUTPUT_STRIP_TRAILING_WHITESPACE ERROR_QUIET)
+	if(NOT revision_)
+		set(revision_ "unknown")
+	endif()
+endif()
+
+cmake_host_system_information(RESULT cores_ QUERY NUMBER_OF_LOGICAL_CORES)
+
+file(WRITE ${OUTPUT}
+	"{\"suite\":\"meta\",\"version\":\"${PROJECT_VERSION}\",\"revision\":\"${revision_}\",\"build_type\":\"${BUILD_TYPE}\",\"compiler\":\"${COMPILER}\",\"system\":\"${CMAKE_HOST_SYSTEM_NAME}\",\"logical_cores\":${cores_},\"time\":\"${when_}\"}\n")
+
+set(failed_ 0)
+foreach(bench_ ${BENCHMARKS})
+	get_filename_component(name_ ${bench_} NAME)
+	message(STATUS "${name_}")
+	execute_process(COMMAND ${bench_} OUTPUT_VARIABLE out_ RESULT_VARIABLE result_)
+	if(NOT result_ EQUAL 0)
+		message(WARNING "${name_} failed: ${result_}")
+		set(failed_ 1)
+	endif()
+	# results only, JSON lines starting with suite and bench; anything else is dropped
+	string(REGEX MATCHALL "{\"suite\":\"[^\"\n]*\",\"bench\":[^\n]*}" lines_ "${out_}")
+	foreach(line_ ${lines_})
+		file(APPEND ${OUTPUT} "${line_}\n")
+	endforeach()
+endforeach()
+
+message(STATUS "results: ${OUTPUT}")
+if(failed_)
+	message(FATAL_ERROR "some benchmarks failed")
+endif()
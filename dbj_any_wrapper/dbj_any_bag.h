@@ -0,0 +1,381 @@
+#pragma once
+
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// dbj any bag -- values of different types, back to back, in one arena
+//
+// std::vector<std::any> is one heap object per element and one pointer
+// to chase per visit. dbj::any::bag bump allocates each value in the
+// current chunk, right behind a one pointer header:
+//
+//   [ vtable* ][ pad ][ T value ][ pad ][ vtable* ] ...
+//
+// vtable is made by the compiler, one per type; its address is the
+// type tag. Each type also has its group: the array of its values
+// addresses, in the order of insertion. visit<T>() walks that array
+// thus it touches only T's, always moving forward through the arena,
+// with no pointer chasing. visit_all() walks the whole arena.
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "../dbj_name.h"
+
+namespace dbj {
+
+	namespace any {
+
+		// manual vtable, one per type
+		struct bag_vtable final {
+			std::size_t size;
+			std::size_t align;
+			// null when trivially destructible
+			void (*destroy)(void*) noexcept;
+			// placement copy from src to dst, null when not copyable
+			void (*copy)(void* dst, const void* src);
+			// human readable name of the type
+			const std::string(*name)() noexcept;
+		};
+
+		namespace details {
+			template <typename T>
+			void bag_destroy(void* p_) noexcept { static_cast<T*>(p_)->~T(); }
+
+			template <typename T>
+			void bag_copy(void* dst_, const void* src_) { ::new (dst_) T(*static_cast<const T*>(src_)); }
+
+			template <typename T>
+			constexpr auto bag_copy_for() noexcept -> void (*)(void*, const void*)
+			{
+				if constexpr (std::is_copy_constructible_v<T>)
+					return &bag_copy<T>;
+				else
+					return nullptr;
+			}
+
+			template <typename T>
+			inline constexpr bag_vtable bag_vtable_for{
+				sizeof(T), alignof(T),
+				std::is_trivially_destructible_v<T> ? nullptr : &bag_destroy<T>,
+				bag_copy_for<T>(),
+				&dbj::name<T>
+			};
+
+			inline std::byte* align_up(std::byte* p_, std::size_t align_) noexcept
+			{
+				const auto v_ = reinterpret_cast<std::uintptr_t>(p_);
+				return reinterpret_cast<std::byte*>((v_ + align_ - 1) & ~(std::uintptr_t)(align_ - 1));
+			}
+		} // details
+
+		// the type tag
+		template <typename T>
+		inline constexpr const bag_vtable* bag_tag = &details::bag_vtable_for<T>;
+
+		class bag final
+		{
+			struct record final {
+				const bag_vtable* vt;
+
+				std::byte* value() noexcept {
+					return details::align_up(reinterpret_cast<std::byte*>(this + 1), vt->align);
+				}
+				record* next() noexcept {
+					return reinterpret_cast<record*>(
+						details::align_up(value() + vt->size, alignof(record)));
+				}
+			};
+
+			struct chunk final {
+				std::unique_ptr<std::byte[]> memory;
+				std::size_t capacity{};
+				std::size_t used{};
+				record* begin() const noexcept { return reinterpret_cast<record*>(memory.get()); }
+				record* end() const noexcept { return reinterpret_cast<record*>(memory.get() + used); }
+			};
+
+			// one per type ever pushed, there are usually very few of them
+			struct group final {
+				const bag_vtable* vt{};
+				std::vector<void*> values{};
+			};
+
+			std::vector<chunk> chunks_{};
+			std::vector<group> groups_{};
+			std::size_t size_{};
+			std::size_t chunk_size_{};
+
+			group& group_for(const bag_vtable* vt_)
+			{
+				for (auto& g_ : groups_)
+					if (g_.vt == vt_) return g_;
+				groups_.push_back(group{ vt_ });
+				return groups_.back();
+			}
+
+			const group* find_group(const bag_vtable* vt_) const noexcept
+			{
+				for (auto& g_ : groups_)
+					if (g_.vt == vt_) return &g_;
+				return nullptr;
+			}
+
+			// room for the header and the value, in the current chunk or in a new one
+			// nothing is committed before link(), thus a throwing constructor
+			// leaves no record behind
+			record* allocate(const bag_vtable* vt_)
+			{
+				const std::size_t worst_ = sizeof(record) + vt_->align + vt_->size + alignof(record);
+
+				if (chunks_.empty() || chunks_.back().capacity - chunks_.back().used < worst_) {
+					const std::size_t capacity_ = worst_ > chunk_size_ ? worst_ : chunk_size_;
+					// operator new[] is aligned enough for the record header
+					// not make_unique, that one would zero the whole chunk
+					chunks_.push_back(chunk{ std::unique_ptr<std::byte[]>(new std::byte[capacity_]), capacity_, 0 });
+				}
+
+				record* r_ = chunks_.back().end();
+				r_->vt = vt_;
+				return r_;
+			}
+
+			// the value in r_ is constructed, make it part of the bag
+			// if that throws the value is destroyed and the record is not used
+			void link(record* r_)
+			{
+				try {
+					group_for(r_->vt).values.push_back(r_->value());
+				}
+				catch (...) {
+					if (r_->vt->destroy) r_->vt->destroy(r_->value());
+					throw;
+				}
+				chunk& c_ = chunks_.back();
+				c_.used = std::size_t(reinterpret_cast<std::byte*>(r_->next()) - c_.memory.get());
+				++size_;
+			}
+
+			bool copyable() const noexcept
+			{
+				for (auto& g_ : groups_)
+					if (!g_.vt->copy) return false;
+				return true;
+			}
+
+		public:
+			using type = bag;
+			static constexpr std::size_t default_chunk_size = 16 * 1024;
+
+			explicit bag(std::size_t chunk_size_arg = default_chunk_size) noexcept
+				: chunk_size_(chunk_size_arg) {
+			}
+
+			// we do not exit; if rhs holds a value that can not be copied
+			// errno is set to EINVAL and the copy is empty
+			bag(const bag& rhs) : chunk_size_(rhs.chunk_size_)
+			{
+				if (!rhs.copyable()) {
+					errno = EINVAL;
+					perror(__FILE__ " -- dbj::any::bag holds a value that can not be copied");
+					return;
+				}
+				try {
+					rhs.visit_all([&](const bag_vtable* vt_, const void* src_) {
+						record* r_ = allocate(vt_);
+						vt_->copy(r_->value(), src_);
+						link(r_);
+						});
+				}
+				catch (...) {
+					clear();
+					throw;
+				}
+			}
+
+			// as the copy, but on EINVAL *this is left as it was
+			bag& operator = (const bag& rhs)
+			{
+				if (this != &rhs) {
+					if (!rhs.copyable()) {
+						errno = EINVAL;
+						perror(__FILE__ " -- dbj::any::bag holds a value that can not be copied");
+						return *this;
+					}
+					bag tmp_(rhs);
+					*this = std::move(tmp_);
+				}
+				return *this;
+			}
+
+			bag(bag&& rhs) noexcept
+				: chunks_(std::move(rhs.chunks_)), groups_(std::move(rhs.groups_)),
+				size_(rhs.size_), chunk_size_(rhs.chunk_size_)
+			{
+				rhs.size_ = 0;
+				rhs.chunks_.clear();
+				rhs.groups_.clear();
+			}
+
+			bag& operator = (bag&& rhs) noexcept
+			{
+				if (this != &rhs) {
+					clear();
+					chunks_ = std::move(rhs.chunks_);
+					groups_ = std::move(rhs.groups_);
+					size_ = rhs.size_;
+					chunk_size_ = rhs.chunk_size_;
+					rhs.size_ = 0;
+					rhs.chunks_.clear();
+					rhs.groups_.clear();
+				}
+				return *this;
+			}
+
+			~bag() { clear(); }
+
+			template <typename T, typename... Args>
+			T& emplace(Args&&... args)
+			{
+				static_assert(!std::is_reference_v<T> && !std::is_array_v<T>,
+					"[dbj::any::bag] Can not store a reference or an array");
+				record* r_ = allocate(bag_tag<T>);
+				T* val_ = ::new (r_->value()) T(std::forward<Args>(args)...);
+				link(r_);
+				return *val_;
+			}
+
+			template <typename T>
+			std::decay_t<T>& push(T&& val_)
+			{
+				static_assert(!std::is_same_v<std::decay_t<T>, const char*>,
+					"[dbj::any::bag] can not use 'char *' pointer argument");
+				return emplace<std::decay_t<T>>(std::forward<T>(val_));
+			}
+
+			std::size_t size() const noexcept { return size_; }
+			std::size_t chunk_size() const noexcept { return chunk_size_; }
+			bool empty() const noexcept { return size_ == 0; }
+
+			template <typename T>
+			std::size_t count() const noexcept
+			{
+				const group* g_ = find_group(bag_tag<T>);
+				return g_ ? g_->values.size() : 0;
+			}
+
+			// only the T's, in the order of insertion
+			template <typename T, typename F>
+			void visit(F&& fun_)
+			{
+				if (const group* g_ = find_group(bag_tag<T>))
+					for (void* v_ : g_->values)
+						fun_(*static_cast<T*>(v_));
+			}
+
+			template <typename T, typename F>
+			void visit(F&& fun_) const
+			{
+				if (const group* g_ = find_group(bag_tag<T>))
+					for (const void* v_ : g_->values)
+						fun_(*static_cast<const T*>(v_));
+			}
+
+			// everything in the order of insertion
+			// fun_(const bag_vtable * tag, const void * value)
+			template <typename F>
+			void visit_all(F&& fun_) const
+			{
+				for (auto& c_ : chunks_)
+					for (record* r_ = c_.begin(); r_ != c_.end(); r_ = r_->next())
+						fun_(r_->vt, static_cast<const void*>(r_->value()));
+			}
+
+			// destroys all, keeps the first chunk for reuse
+			void clear() noexcept
+			{
+				// trivially destructible groups are not even looked at
+				for (auto& g_ : groups_)
+					if (g_.vt->destroy)
+						for (void* v_ : g_.values)
+							g_.vt->destroy(v_);
+				if (chunks_.size() > 1)
+					chunks_.resize(1);
+				if (!chunks_.empty())
+					chunks_.front().used = 0;
+				groups_.clear();
+				size_ = 0;
+			}
+		}; // bag
+	} // any
+} // dbj
+
+namespace {
+
+	inline void test_dbj_any_bag() noexcept
+	{
+		dbj::any::bag bag_{};
+
+		bag_.push(42);
+		bag_.push(3.14);
+		bag_.push(std::string("Hello dbj any bag!"));
+		bag_.push(13);
+
+		assert(bag_.size() == 4);
+		assert(bag_.count<int>() == 2);
+		assert(bag_.count<char>() == 0);
+
+		int sum_{};
+		bag_.visit<int>([&](int& i_) { sum_ += i_; });
+		assert(sum_ == 55);
+
+		// deep copy, strings are copied too
+		dbj::any::bag copy_{ bag_ };
+		std::size_t string_len_{};
+		copy_.visit<std::string>([&](std::string& s_) { string_len_ += s_.size(); });
+		assert(string_len_ == 18);
+
+		// throwing constructor leaves nothing behind
+		struct throws_ final {
+			explicit throws_(int) { throw 42; }
+		};
+		try { bag_.emplace<throws_>(0); }
+		catch (int) {}
+		std::size_t visited_{};
+		bag_.visit_all([&](const dbj::any::bag_vtable*, const void*) { ++visited_; });
+		assert(visited_ == bag_.size() && bag_.size() == 4);
+
+		// no copy of a bag holding move only values
+		dbj::any::bag move_only_{};
+		move_only_.push(std::make_unique<int>(42));
+		errno = 0;
+		dbj::any::bag not_copied_{ move_only_ };
+		assert(not_copied_.empty() && errno == EINVAL);
+
+		dbj::any::bag two_ints_{};
+		two_ints_.push(1);
+		two_ints_.push(2);
+		errno = 0;
+		two_ints_ = move_only_;
+		assert(two_ints_.size() == 2 && errno == EINVAL);
+
+		dbj::any::bag small_chunks_{ 256 };
+		dbj::any::bag moved_to_{};
+		moved_to_ = std::move(small_chunks_);
+		assert(moved_to_.chunk_size() == 256);
+
+		printf("\n\ndbj::any::bag of %zu [", copy_.size());
+		copy_.visit_all([](const dbj::any::bag_vtable* tag_, const void*) {
+			printf(" %s", tag_->name().c_str());
+			});
+		printf(" ]");
+	}
+} // nspace
@@ -0,0 +1,327 @@
+#pragma once
+
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// dbj::any::callable and dbj::any::function_ref -- callables for
+// event dispatch loops
+//
+// callable<R(Args...)> owns the callable. If it fits the small buffer
+// it is kept inside, otherwise on the heap. Calling it is one indirect
+// call through the invoker kept in the object itself; nothing is copied
+// per call. Trivially copyable callables (function pointers, lambdas
+// capturing pointers or ints) are copied with memcpy and never destroyed.
+//
+// function_ref<R(Args...)> does not own, it is two pointers, it is
+// for passing callables down the call stack.
+//
+// we do not use exceptions and we do not exit, on empty call we
+// set errno to EINVAL and return R{}, as make_guid does on wrong input
+//
+// dispatch(first_, last_, args...) calls each non empty callable
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace dbj {
+
+	namespace any {
+
+		namespace details {
+			// what empty_call() can return
+			template <typename R>
+			constexpr inline bool empty_call_result =
+				std::is_void_v<R> || (!std::is_reference_v<R> && std::is_default_constructible_v<R>);
+
+			template <typename R>
+			inline R empty_call() noexcept
+			{
+				errno = EINVAL;
+				perror(__FILE__ " -- can not call on empty callable");
+				if constexpr (!std::is_void_v<R>)
+					return R{};
+			}
+		} // details
+
+		template <typename Signature, std::size_t BUFFER_SIZE = 4 * sizeof(void*)>
+		class callable;
+
+		template <typename R, typename... Args, std::size_t BUFFER_SIZE>
+		class callable<R(Args...), BUFFER_SIZE> final
+		{
+			static_assert(BUFFER_SIZE >= sizeof(void*),
+				"[dbj::any::callable] buffer must hold at least a pointer");
+			static_assert(details::empty_call_result<R>,
+				"[dbj::any::callable] R must be void or default constructible and not a reference, "
+				"R{} is returned from the empty call");
+
+			using invoker_type = R(*)(void*, Args&&...);
+
+			// null ops_ means trivially copyable and destructible
+			struct ops final {
+				void (*copy)(void* dst, const void* src);
+				void (*move)(void* dst, void* src) noexcept;
+				void (*destroy)(void*) noexcept;
+			};
+
+			template <typename F>
+			static constexpr bool fits_inside =
+				sizeof(F) <= BUFFER_SIZE &&
+				alignof(F) <= alignof(std::max_align_t) &&
+				std::is_nothrow_move_constructible_v<F>;
+
+			template <typename F>
+			static R invoke_inside(void* p_, Args&&... args)
+			{
+				return std::invoke(*static_cast<F*>(p_), std::forward<Args>(args)...);
+			}
+
+			template <typename F>
+			static R invoke_heap(void* p_, Args&&... args)
+			{
+				return std::invoke(**static_cast<F**>(p_), std::forward<Args>(args)...);
+			}
+
+			template <typename F>
+			static constexpr ops inside_ops{
+				[](void* dst_, const void* src_) { ::new (dst_) F(*static_cast<const F*>(src_)); },
+				[](void* dst_, void* src_) noexcept { ::new (dst_) F(std::move(*static_cast<F*>(src_))); },
+				[](void* p_) noexcept { static_cast<F*>(p_)->~F(); }
+			};
+
+			template <typename F>
+			static constexpr ops heap_ops{
+				[](void* dst_, const void* src_) { *static_cast<F**>(dst_) = new F(**static_cast<F* const*>(src_)); },
+				[](void* dst_, void* src_) noexcept {
+					*static_cast<F**>(dst_) = *static_cast<F**>(src_);
+					*static_cast<F**>(src_) = nullptr;
+				},
+				[](void* p_) noexcept { delete* static_cast<F**>(p_); }
+			};
+
+			invoker_type invoke_{};
+			const ops* ops_{};
+			alignas(std::max_align_t) std::byte buffer_[BUFFER_SIZE]{};
+
+			// *this is empty when called, and stays empty if the copy throws
+			void copy_from(const callable& rhs)
+			{
+				if (rhs.ops_) rhs.ops_->copy(buffer_, rhs.buffer_);
+				else std::memcpy(buffer_, rhs.buffer_, BUFFER_SIZE);
+				invoke_ = rhs.invoke_;
+				ops_ = rhs.ops_;
+			}
+
+			void move_from(callable& rhs) noexcept
+			{
+				invoke_ = rhs.invoke_;
+				ops_ = rhs.ops_;
+				if (ops_) ops_->move(buffer_, rhs.buffer_);
+				else std::memcpy(buffer_, rhs.buffer_, BUFFER_SIZE);
+				rhs.reset();
+			}
+
+		public:
+			using type = callable;
+			using result_type = R;
+			static constexpr std::size_t buffer_size = BUFFER_SIZE;
+
+			callable() noexcept {}
+
+			template <typename F, typename FD = std::decay_t<F>,
+				std::enable_if_t<!std::is_same_v<FD, callable>&& std::is_invocable_r_v<R, FD&, Args...>, int> = 0>
+				callable(F&& fun_)
+			{
+				if constexpr (std::is_pointer_v<FD> || std::is_member_pointer_v<FD>) {
+					if (!fun_) return; // null pointer is an empty callable
+				}
+
+				if constexpr (fits_inside<FD>) {
+					::new (static_cast<void*>(buffer_)) FD(std::forward<F>(fun_));
+					invoke_ = &invoke_inside<FD>;
+					if constexpr (!(std::is_trivially_copyable_v<FD> && std::is_trivially_destructible_v<FD>))
+						ops_ = &inside_ops<FD>;
+				}
+				else {
+					*reinterpret_cast<FD**>(buffer_) = new FD(std::forward<F>(fun_));
+					invoke_ = &invoke_heap<FD>;
+					ops_ = &heap_ops<FD>;
+				}
+			}
+
+			callable(const callable& rhs) { copy_from(rhs); }
+			callable(callable&& rhs) noexcept { move_from(rhs); }
+
+			callable& operator=(const callable& rhs)
+			{
+				if (this != &rhs) {
+					reset();
+					copy_from(rhs);
+				}
+				return *this;
+			}
+
+			callable& operator=(callable&& rhs) noexcept
+			{
+				if (this != &rhs) {
+					reset();
+					move_from(rhs);
+				}
+				return *this;
+			}
+
+			~callable() { reset(); }
+
+			void reset() noexcept
+			{
+				if (ops_) ops_->destroy(buffer_);
+				invoke_ = nullptr;
+				ops_ = nullptr;
+			}
+
+			bool empty() const noexcept { return invoke_ == nullptr; }
+			explicit operator bool() const noexcept { return invoke_ != nullptr; }
+
+			// one indirect call, no copy
+			R operator() (Args... args) const
+			{
+				if (invoke_)
+					return invoke_(const_cast<std::byte*>(buffer_), std::forward<Args>(args)...);
+				return details::empty_call<R>();
+			}
+		}; // callable
+
+		template <typename Signature>
+		class function_ref;
+
+		template <typename R, typename... Args>
+		class function_ref<R(Args...)> final
+		{
+			union target final {
+				void* object;
+				void (*function)();
+			};
+
+			target target_{};
+			R(*invoke_)(target, Args&&...) {};
+
+			static_assert(details::empty_call_result<R>,
+				"[dbj::any::function_ref] R must be void or default constructible and not a reference, "
+				"R{} is returned from the empty call");
+
+		public:
+			using type = function_ref;
+			using result_type = R;
+
+			function_ref() noexcept {}
+
+			// the callable must outlive the function_ref
+			template <typename F, typename FD = std::remove_reference_t<F>,
+				std::enable_if_t<!std::is_same_v<std::decay_t<F>, function_ref>&& std::is_invocable_r_v<R, FD&, Args...>, int> = 0>
+				function_ref(F&& fun_) noexcept
+			{
+				if constexpr (std::is_function_v<FD> || std::is_pointer_v<std::decay_t<F>>) {
+					using fp_type = std::decay_t<F>;
+					if constexpr (std::is_pointer_v<FD>) {
+						if (!fun_) return;
+					}
+					target_.function = reinterpret_cast<void (*)()>(static_cast<fp_type>(fun_));
+					invoke_ = [](target t_, Args&&... args) -> R {
+						return std::invoke(reinterpret_cast<fp_type>(t_.function), std::forward<Args>(args)...);
+					};
+				}
+				else {
+					target_.object = const_cast<void*>(static_cast<const void*>(std::addressof(fun_)));
+					invoke_ = [](target t_, Args&&... args) -> R {
+						return std::invoke(*static_cast<FD*>(t_.object), std::forward<Args>(args)...);
+					};
+				}
+			}
+
+			bool empty() const noexcept { return invoke_ == nullptr; }
+			explicit operator bool() const noexcept { return invoke_ != nullptr; }
+
+			R operator() (Args... args) const
+			{
+				if (invoke_)
+					return invoke_(target_, std::forward<Args>(args)...);
+				return details::empty_call<R>();
+			}
+		}; // function_ref
+
+		// calls each of the non empty callables in [first_, last_)
+		// with the same arguments, returns how many were called
+		template <typename C, typename... Args>
+		inline std::size_t dispatch(const C* first_, const C* last_, Args&&... args)
+		{
+			std::size_t called_{ 0 };
+			for (; first_ != last_; ++first_) {
+				if (first_->empty()) continue;
+				(*first_)(args...);
+				++called_;
+			}
+			return called_;
+		}
+	} // any
+} // dbj
+
+namespace {
+
+	inline int dbj_any_callable_sum(int a_, int b_) { return a_ + b_; }
+
+	inline void test_dbj_any_callable() noexcept
+	{
+		using dbj::any::callable;
+		using dbj::any::function_ref;
+
+		int counter_{ 0 };
+		callable<void(int)> small_ = [&](int i_) { counter_ += i_; };
+		small_(2);
+		assert(counter_ == 2);
+
+		// bigger than the buffer, goes to the heap
+		char big_[128]{ 'd', 'b', 'j' };
+		callable<char(int)> big_one_ = [big_](int i_) { return big_[i_]; };
+		callable<char(int)> big_copy_ = big_one_;
+		assert(big_copy_(1) == 'b');
+
+		callable<int(int, int)> fp_ = &dbj_any_callable_sum;
+		assert(fp_(1, 2) == 3);
+
+		// callable<int&()> does not compile, there is no R{} to return
+		static_assert(!dbj::any::details::empty_call_result<int&>);
+		static_assert(dbj::any::details::empty_call_result<void>);
+
+		// no exit on empty call
+		callable<int(int, int)> empty_{};
+		errno = 0;
+		assert(empty_(1, 2) == 0 && errno == EINVAL);
+
+		auto lambda_ = [](int a_, int b_) { return a_ * b_; };
+		function_ref<int(int, int)> ref_ = lambda_;
+		assert(ref_(3, 4) == 12);
+		function_ref<int(int, int)> ref_fp_ = dbj_any_callable_sum;
+		assert(ref_fp_(3, 4) == 7);
+		(void)ref_; (void)ref_fp_;
+
+		// dbj::any::wrapper calls a mutable callable on a copy
+		auto next_ = [n_ = 0]() mutable { return ++n_; };
+		auto wrapped_next_ = dbj::any::wrapper<decltype(next_)>::make(next_);
+		assert(wrapped_next_() == 1 && wrapped_next_() == 1);
+		auto wrapped_sum_ = dbj::any::wrapper<decltype(lambda_)>::make(lambda_);
+		assert(wrapped_sum_(2, 3) == 6);
+		(void)wrapped_next_; (void)wrapped_sum_;
+
+		callable<void(int)> handlers_[]{ small_, {}, small_ };
+		assert(dbj::any::dispatch(handlers_, handlers_ + 3, 10) == 2);
+		assert(counter_ == 22);
+
+		printf("\n\ncallable buffer: %zu bytes, sizeof callable: %zu, sizeof function_ref: %zu",
+			callable<void(int)>::buffer_size, sizeof(callable<void(int)>), sizeof(function_ref<void(int)>));
+	}
+} // nspace
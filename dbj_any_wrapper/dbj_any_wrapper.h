@@ -2,10 +2,14 @@
 
 #include <any>
 #include <array>
+#include <cerrno>
 #include <string>
 #include <cstdio>
+#include <functional>
+#include <type_traits>
 
 #include "dbj_name.h"
+#include "../dbj_instrument.h"
 
 // 2018 dbj@dbj created -- std any with identity
 namespace dbj {
@@ -14,6 +18,21 @@ namespace dbj {
 
 		using namespace std;
 
+		namespace details {
+			// does std::any put T on the heap; this is the small object
+			// rule of the std lib in use, only as precise as instrumentation needs
+#if defined(_LIBCPP_VERSION)
+			constexpr inline size_t any_small_size = 3 * sizeof(void*);
+#elif defined(_MSC_VER)
+			constexpr inline size_t any_small_size = 6 * sizeof(void*);
+#else // libstdc++
+			constexpr inline size_t any_small_size = sizeof(void*);
+#endif
+			template <typename T>
+			constexpr inline bool any_allocates = !(sizeof(T) <= any_small_size &&
+				alignof(T) <= alignof(void*) && is_nothrow_move_constructible_v<T>);
+		} // details
+
 		template <typename T> class wrapper;
 
 		template <typename T>
@@ -40,20 +59,29 @@ namespace dbj {
 
 			explicit wrapper(data_type val_) noexcept
 				: any_(val_) {
+				if constexpr (details::any_allocates<T>) DBJ_INSTRUMENT_EVENT(wrapper_heap_alloc);
 			}
 			// copy
-			wrapper(const wrapper& rhs) noexcept : any_(rhs.any_) { }
+			wrapper(const wrapper& rhs) noexcept : any_(rhs.any_) {
+				DBJ_INSTRUMENT_EVENT(wrapper_copy);
+				if constexpr (details::any_allocates<T>) if (!rhs.empty()) DBJ_INSTRUMENT_EVENT(wrapper_heap_alloc);
+			}
 			wrapper& operator=(const wrapper& x) noexcept {
 				if (this != &x) {
+					DBJ_INSTRUMENT_EVENT(wrapper_copy);
+					if constexpr (details::any_allocates<T>) if (!x.empty()) DBJ_INSTRUMENT_EVENT(wrapper_heap_alloc);
 					this->any_ = x.any_;
 				}
 				return *this;
 			}
 			// move
-			wrapper(wrapper&& rhs) noexcept : any_(move(rhs.any_)) {  }
+			wrapper(wrapper&& rhs) noexcept : any_(move(rhs.any_)) {
+				DBJ_INSTRUMENT_EVENT(wrapper_move);
+			}
 
 			wrapper& operator=(wrapper&& x) noexcept {
 				if (this != &x) {
+					DBJ_INSTRUMENT_EVENT(wrapper_move);
 					this->any_ = move(x.any_);
 				}
 				return *this;
@@ -69,20 +97,45 @@ namespace dbj {
 
 			// data_type && get()		const noexcept { return move(any_cast<data_type>(this->any_)); }
 
+			// const callables are called in place, through const T&
+			// the others (e.g. mutable lambdas) on a copy, as before, thus
+			// their state does not persist between the calls
+			template< class... ArgTypes >
+			using call_result_t = typename conditional_t<is_invocable_v<const T&, ArgTypes...>,
+				invoke_result<const T&, ArgTypes...>, invoke_result<T&, ArgTypes...>>::type;
+
 			// only if function is stored
+			// on empty we set errno to EINVAL and return the default value
+			// for dispatch loops see dbj::any::callable
 			template< class... ArgTypes >
-			invoke_result_t<T&, ArgTypes...>
+			call_result_t<ArgTypes...>
 				operator() (ArgTypes&&... args) const {
-				if (!empty()) {
-					return invoke(get(), forward<ArgTypes>(args)...);
+				using result_type = call_result_t<ArgTypes...>;
+				static_assert(is_void_v<result_type> ||
+					(!is_reference_v<result_type> && is_default_constructible_v<result_type>),
+					"[dbj::wrapper] result must be void or default constructible and not a reference, "
+					"it is returned from the empty call");
+
+				DBJ_INSTRUMENT_EVENT(wrapper_any_cast);
+				if (const auto* fun_ = any_cast<data_type>(&this->any_)) {
+					if constexpr (is_invocable_v<const T&, ArgTypes...>) {
+						return invoke(*fun_, forward<ArgTypes>(args)...);
+					}
+					else {
+						data_type copy_{ *fun_ };
+						return invoke(copy_, forward<ArgTypes>(args)...);
+					}
 				}
 
+				errno = EINVAL;
 				perror("can not call on empty data wrapped ");
-				exit(0);
+				if constexpr (!is_void_v<result_type>)
+					return result_type{};
 			}
 
 			data_type get() const noexcept {
 
+				DBJ_INSTRUMENT_EVENT(wrapper_any_cast);
 				return any_cast<data_type>(this->any_);
 				// return data_type{};
 			}
@@ -113,13 +166,13 @@ namespace dbj {
 			// factory methods ----------------------------------------
 
 			template <
-				typename T,
-				typename ANYW = typename type
+				typename V,
+				typename ANYW = type
 			>
-				static auto make(T val_)
+				static auto make(V val_)
 				-> ANYW
 			{
-				static_assert(!std::is_same<const char*, T>(),
+				static_assert(!std::is_same<const char*, V>(),
 					"std::any::make() can not use 'char *' pointer argument");
 
 				return ANYW{ val_ };
@@ -127,6 +180,63 @@ namespace dbj {
 
 		}; // any::wrapper
 
+		// std::any is not a literal type thus wrapper<T> can not be constexpr
+		// literal_wrapper<T> is, for trivially copyable T
+		// constant tables of them are made by the compiler and live
+		// in the read only data, no runtime initialization at all
+		template <typename T>
+		class literal_wrapper final
+		{
+			static_assert(!std::is_reference<T>::value,
+				"[dbj::literal_wrapper] Can not use a reference type");
+			static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+				"[dbj::literal_wrapper] T must be trivially copyable and destructible");
+			static_assert(std::is_default_constructible<T>::value,
+				"[dbj::literal_wrapper] T must be default constructible");
+
+			T val_{};
+			bool has_value_{ false };
+
+		public:
+			// types
+			typedef literal_wrapper type;
+			typedef T data_type;
+
+			constexpr literal_wrapper() noexcept = default;
+
+			constexpr explicit literal_wrapper(data_type val_arg) noexcept
+				: val_(val_arg), has_value_(true) {
+			}
+
+			// copy and move are trivial, as T's are
+
+			constexpr operator data_type const& () const noexcept { return val_; }
+
+			constexpr data_type get() const noexcept { return val_; }
+
+			constexpr bool empty() const noexcept { return !has_value_; }
+
+			const std::string to_string() const noexcept
+			{
+				return { std::to_string(val_) };
+			}
+
+			// factory methods ----------------------------------------
+
+			template <
+				typename V,
+				typename ANYW = type
+			>
+				static constexpr auto make(V val_)
+				-> ANYW
+			{
+				static_assert(!std::is_same<const char*, V>(),
+					"literal_wrapper::make() can not use 'char *' pointer argument");
+
+				return ANYW{ val_ };
+			};
+		}; // any::literal_wrapper
+
 		// input is T[N] native array 
 		// each element of an T[N] is any wrapped
 		// and the result is kept inside std::aray
@@ -137,7 +247,7 @@ namespace dbj {
 			typename ANYW = wrapper<T>,
 			typename RETT = typename std::array< ANYW, N >
 		>
-			inline auto wrapper_range(const T(&arrf)[N])
+			constexpr inline auto wrapper_range(const T(&arrf)[N])
 			-> RETT
 		{
 			RETT rezult{};
@@ -148,6 +258,18 @@ namespace dbj {
 			}
 			return rezult;
 		};
+
+		// the same but compile time
+		// constexpr auto arr_of_wraps = literal_range(int_arr);
+		template <
+			typename T,
+			std::size_t N
+		>
+			constexpr inline auto literal_range(const T(&arrf)[N])
+			-> std::array< literal_wrapper<T>, N >
+		{
+			return wrapper_range<T, N, literal_wrapper<T>>(arrf);
+		};
 	} // any
 } // dbj
 
@@ -196,6 +318,23 @@ namespace {
 			types_show(word_, arr_of_wraps);
 			arr_print(arr_of_wraps);
 		}
+
+		// the same tables, this time made by the compiler
+		{
+			static constexpr int int_arr[]{ 42 };
+			static constexpr std::array arr_of_wraps = any::literal_range(int_arr);
+			static_assert(arr_of_wraps[0].get() == 42);
+			static_assert(!arr_of_wraps[0].empty());
+			types_show(int_arr, arr_of_wraps);
+			arr_print(arr_of_wraps);
+		}
+		{
+			static constexpr char word_[] = "Hello dbj any!";
+			static constexpr std::array arr_of_wraps = any::literal_range(word_);
+			static_assert(arr_of_wraps[0].get() == 'H');
+			types_show(word_, arr_of_wraps);
+			arr_print(arr_of_wraps);
+		}
 	}
 }
 
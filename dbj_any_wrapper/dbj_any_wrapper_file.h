@@ -0,0 +1,395 @@
+#pragma once
+
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// dbj any wrapper file -- ranges of wrapped trivially copyable T's
+// written to disk and mapped back with no deserialization pass
+//
+// file layout, version 1, native byte order:
+//
+//   [ file_header, 64 bytes                               ]
+//   [ presence bitmap, 1 bit per element, 1 == has value  ]
+//   [ pad to 64                                           ]
+//   [ T[count], empty elements are zeroed                 ]
+//
+// the type tag is twofold: hash of dbj::name<T>() which is checked
+// always, and optional dbj::GUID given by the writer, checked when the
+// reader is given one too. Note: dbj::name<T>() is compiler specific,
+// files made by one compiler are read by the same one.
+//
+// we do not use exceptions; write_range() returns false, mapped_range
+// is not valid(), errno tells why
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "dbj_any_wrapper.h"
+#include "../dbj_guid/dbj_guid.h"
+
+#ifdef _WIN32
+// as with rpc.h in dbj_guid.h we shall not #include windows.h
+// the types are spelled exactly as the SDK ones resolve, thus
+// windows.h may be included before or after this header
+// LARGE_INTEGER and SECURITY_ATTRIBUTES are used only through pointers
+union _LARGE_INTEGER;
+struct _SECURITY_ATTRIBUTES;
+#ifndef _WINDOWS_
+extern "C" {
+#ifdef _WIN64
+	typedef unsigned __int64 dbj_size_t_; // SIZE_T
+#else
+	typedef unsigned long dbj_size_t_;
+#endif
+	__declspec(dllimport) void* __stdcall CreateFileA(const char*, unsigned long, unsigned long, _SECURITY_ATTRIBUTES*, unsigned long, unsigned long, void*);
+	__declspec(dllimport) void* __stdcall CreateFileMappingA(void*, _SECURITY_ATTRIBUTES*, unsigned long, unsigned long, unsigned long, const char*);
+	__declspec(dllimport) void* __stdcall MapViewOfFile(void*, unsigned long, unsigned long, unsigned long, dbj_size_t_);
+	__declspec(dllimport) int __stdcall UnmapViewOfFile(const void*);
+	__declspec(dllimport) int __stdcall CloseHandle(void*);
+	__declspec(dllimport) int __stdcall GetFileSizeEx(void*, _LARGE_INTEGER*);
+} // "C"
+#endif // ! _WINDOWS_
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+namespace dbj {
+
+	namespace any {
+
+		struct file_header final {
+			char magic[8];             // "DBJWRAP"
+			uint32_t version;
+			uint32_t byte_order;       // 0x01020304 as written
+			dbj::GUID type_guid;       // null_guid when not given
+			uint64_t type_hash;        // FNV-1a of dbj::name<T>()
+			uint64_t count;
+			uint32_t element_size;
+			uint32_t element_align;
+			uint32_t bitmap_offset;    // from the start of the file
+			uint32_t data_offset;      // ditto, multiple of 64
+		};
+		static_assert(sizeof(file_header) == 64, "[dbj::any::file_header] must be 64 bytes");
+
+		namespace details {
+
+			constexpr inline char file_magic[8]{ 'D', 'B', 'J', 'W', 'R', 'A', 'P', 0 };
+			constexpr inline uint32_t file_version = 1;
+			constexpr inline uint32_t file_byte_order = 0x01020304;
+			constexpr inline std::size_t file_data_align = 64;
+
+			inline uint64_t fnv1a(const std::string& str_) noexcept
+			{
+				uint64_t hash_ = 0xcbf29ce484222325ULL;
+				for (unsigned char c_ : str_) {
+					hash_ ^= c_;
+					hash_ *= 0x100000001b3ULL;
+				}
+				return hash_;
+			}
+
+			template <typename T>
+			inline uint64_t type_hash() noexcept { return fnv1a(dbj::name<T>()); }
+
+			template <typename T>
+			inline file_header make_file_header(std::size_t count_, const dbj::GUID& type_guid_) noexcept
+			{
+				file_header h_{};
+				std::memcpy(h_.magic, file_magic, sizeof(h_.magic));
+				h_.version = file_version;
+				h_.byte_order = file_byte_order;
+				h_.type_guid = type_guid_;
+				h_.type_hash = type_hash<T>();
+				h_.count = count_;
+				h_.element_size = uint32_t(sizeof(T));
+				h_.element_align = uint32_t(alignof(T));
+				h_.bitmap_offset = uint32_t(sizeof(file_header));
+				const std::size_t bitmap_end_ = sizeof(file_header) + (count_ + 7) / 8;
+				h_.data_offset = uint32_t((bitmap_end_ + file_data_align - 1) / file_data_align * file_data_align);
+				return h_;
+			}
+		} // details
+
+		// anything with data_type, empty() and get() will do:
+		// wrapper<T>, literal_wrapper<T>, pmr::wrapper<T>, mapped_range<T>
+		template <typename RANGE>
+		inline bool write_range(const char* path_, const RANGE& range_, const dbj::GUID& type_guid_ = dbj::null_guid)
+		{
+			using element_type = std::decay_t<decltype(*std::begin(range_))>;
+			using T = typename element_type::data_type;
+			static_assert(std::is_trivially_copyable<T>::value,
+				"[dbj::any::write_range] only trivially copyable types can be written");
+			static_assert(alignof(T) <= details::file_data_align,
+				"[dbj::any::write_range] alignment of T is too large");
+
+			std::size_t count_{ 0 };
+			for (auto it_ = std::begin(range_); it_ != std::end(range_); ++it_) ++count_;
+
+			const file_header h_ = details::make_file_header<T>(count_, type_guid_);
+
+			FILE* fp_ = std::fopen(path_, "wb");
+			if (!fp_) return false;
+
+			bool ok_ = std::fwrite(&h_, sizeof(h_), 1, fp_) == 1;
+
+			// bitmap
+			unsigned char bits_{ 0 };
+			std::size_t j{ 0 };
+			for (auto it_ = std::begin(range_); ok_ && it_ != std::end(range_); ++it_, ++j) {
+				if (!it_->empty()) bits_ |= (unsigned char)(1u << (j % 8));
+				if (j % 8 == 7) {
+					ok_ = std::fputc(bits_, fp_) != EOF;
+					bits_ = 0;
+				}
+			}
+			if (ok_ && j % 8) ok_ = std::fputc(bits_, fp_) != EOF;
+
+			// pad
+			for (std::size_t p_ = h_.bitmap_offset + (count_ + 7) / 8; ok_ && p_ < h_.data_offset; ++p_)
+				ok_ = std::fputc(0, fp_) != EOF;
+
+			// data
+			for (auto it_ = std::begin(range_); ok_ && it_ != std::end(range_); ++it_) {
+				T val_{};
+				if (!it_->empty()) val_ = it_->get();
+				ok_ = std::fwrite(&val_, sizeof(T), 1, fp_) == 1;
+			}
+
+			ok_ = (std::fclose(fp_) == 0) && ok_;
+			return ok_;
+		}
+
+		// read only view of the file, element access is a pointer offset
+		template <typename T>
+		class mapped_range final
+		{
+			static_assert(std::is_trivially_copyable<T>::value,
+				"[dbj::any::mapped_range] only trivially copyable types can be mapped");
+
+			const unsigned char* base_{};
+			std::size_t length_{};
+			const file_header* header_{};
+			const unsigned char* bitmap_{};
+			const T* data_{};
+#ifdef _WIN32
+			void* file_{};
+			void* mapping_{};
+#endif
+
+			void unmap() noexcept
+			{
+#ifdef _WIN32
+				if (base_) UnmapViewOfFile(base_);
+				if (mapping_) CloseHandle(mapping_);
+				if (file_ && file_ != (void*)(intptr_t)-1) CloseHandle(file_);
+				file_ = mapping_ = nullptr;
+#else
+				if (base_) ::munmap(const_cast<unsigned char*>(base_), length_);
+#endif
+				base_ = nullptr;
+				header_ = nullptr;
+				bitmap_ = nullptr;
+				data_ = nullptr;
+				length_ = 0;
+			}
+
+			bool map(const char* path_) noexcept
+			{
+#ifdef _WIN32
+				constexpr unsigned long generic_read_ = 0x80000000UL, file_share_read_ = 1, open_existing_ = 3;
+				constexpr unsigned long page_readonly_ = 0x02, file_map_read_ = 0x04;
+				file_ = CreateFileA(path_, generic_read_, file_share_read_, nullptr, open_existing_, 0, nullptr);
+				if (file_ == (void*)(intptr_t)-1) { errno = ENOENT; return false; }
+				// LARGE_INTEGER is a union over one 64 bit QuadPart
+				long long size_{};
+				if (!GetFileSizeEx(file_, reinterpret_cast<_LARGE_INTEGER*>(&size_)) || size_ <= 0) { errno = EINVAL; return false; }
+				mapping_ = CreateFileMappingA(file_, nullptr, page_readonly_, 0, 0, nullptr);
+				if (!mapping_) { errno = EACCES; return false; }
+				base_ = static_cast<const unsigned char*>(MapViewOfFile(mapping_, file_map_read_, 0, 0, 0));
+				if (!base_) { errno = ENOMEM; return false; }
+				length_ = std::size_t(size_);
+#else
+				const int fd_ = ::open(path_, O_RDONLY);
+				if (fd_ < 0) return false;
+				struct stat st_ {};
+				if (::fstat(fd_, &st_) != 0 || st_.st_size <= 0) {
+					::close(fd_);
+					errno = EINVAL;
+					return false;
+				}
+				void* p_ = ::mmap(nullptr, std::size_t(st_.st_size), PROT_READ, MAP_SHARED, fd_, 0);
+				::close(fd_); // the mapping keeps the file
+				if (p_ == MAP_FAILED) return false;
+				base_ = static_cast<const unsigned char*>(p_);
+				length_ = std::size_t(st_.st_size);
+#endif
+				return true;
+			}
+
+			bool check(const dbj::GUID& type_guid_) noexcept
+			{
+				if (length_ < sizeof(file_header)) return false;
+				header_ = reinterpret_cast<const file_header*>(base_);
+				const file_header& h_ = *header_;
+
+				if (std::memcmp(h_.magic, details::file_magic, sizeof(h_.magic)) != 0) return false;
+				if (h_.version != details::file_version) return false;
+				if (h_.byte_order != details::file_byte_order) return false;
+				if (h_.element_size != sizeof(T) || h_.element_align != alignof(T)) return false;
+				if (h_.type_hash != details::type_hash<T>()) return false;
+				if (!dbj::is_null(type_guid_) && h_.type_guid != type_guid_) return false;
+				// the file may be corrupt or made up, nothing here can overflow
+				const uint64_t length_64_ = length_;
+				const uint64_t bitmap_bytes_ = h_.count / 8 + (h_.count % 8 ? 1 : 0);
+				if (h_.data_offset % details::file_data_align) return false;
+				if (h_.bitmap_offset < sizeof(file_header)) return false;
+				if (h_.bitmap_offset > h_.data_offset) return false;
+				if (h_.data_offset > length_64_) return false;
+				if (h_.count > (length_64_ - h_.data_offset) / sizeof(T)) return false;
+				if (bitmap_bytes_ > uint64_t(h_.data_offset) - h_.bitmap_offset) return false;
+
+				bitmap_ = base_ + h_.bitmap_offset;
+				data_ = reinterpret_cast<const T*>(base_ + h_.data_offset);
+				return true;
+			}
+
+		public:
+			using type = mapped_range;
+			using data_type = T;
+			using value_type = literal_wrapper<T>;
+
+			mapped_range() noexcept = default;
+
+			// type_guid_ == null_guid means: do not check the GUID tag
+			explicit mapped_range(const char* path_, const dbj::GUID& type_guid_ = dbj::null_guid) noexcept
+			{
+				if (!map(path_)) { unmap(); return; }
+				if (!check(type_guid_)) {
+					unmap();
+					errno = EINVAL;
+				}
+			}
+
+			mapped_range(const mapped_range&) = delete;
+			mapped_range& operator = (const mapped_range&) = delete;
+
+			mapped_range(mapped_range&& rhs) noexcept { *this = std::move(rhs); }
+			mapped_range& operator = (mapped_range&& rhs) noexcept
+			{
+				if (this != &rhs) {
+					unmap();
+					base_ = rhs.base_; length_ = rhs.length_; header_ = rhs.header_;
+					bitmap_ = rhs.bitmap_; data_ = rhs.data_;
+#ifdef _WIN32
+					file_ = rhs.file_; mapping_ = rhs.mapping_;
+					rhs.file_ = rhs.mapping_ = nullptr;
+#endif
+					rhs.base_ = nullptr;
+					rhs.unmap();
+				}
+				return *this;
+			}
+
+			~mapped_range() { unmap(); }
+
+			bool valid() const noexcept { return data_ != nullptr; }
+			std::size_t size() const noexcept { return header_ ? std::size_t(header_->count) : 0; }
+			const file_header* header() const noexcept { return header_; }
+
+			// the raw array, empty elements are zeroed
+			const T* data() const noexcept { return data_; }
+
+			bool empty(std::size_t j) const noexcept
+			{
+				return !(bitmap_[j / 8] & (1u << (j % 8)));
+			}
+
+			value_type operator[](std::size_t j) const noexcept
+			{
+				return empty(j) ? value_type{} : value_type{ data_[j] };
+			}
+
+			// for range for, yields literal_wrapper<T> by value
+			class iterator final {
+				const mapped_range* range_{};
+				std::size_t j_{};
+			public:
+				iterator(const mapped_range* r_, std::size_t j) noexcept : range_(r_), j_(j) {}
+				value_type operator*() const noexcept { return (*range_)[j_]; }
+				struct arrow final { value_type v_; const value_type* operator->() const noexcept { return &v_; } };
+				arrow operator->() const noexcept { return arrow{ (*range_)[j_] }; }
+				iterator& operator++() noexcept { ++j_; return *this; }
+				bool operator!=(const iterator& rhs) const noexcept { return j_ != rhs.j_; }
+				bool operator==(const iterator& rhs) const noexcept { return j_ == rhs.j_; }
+			};
+
+			iterator begin() const noexcept { return { this, 0 }; }
+			iterator end() const noexcept { return { this, size() }; }
+		}; // mapped_range
+	} // any
+} // dbj
+
+namespace {
+
+	inline void test_dbj_any_wrapper_file() noexcept
+	{
+		using namespace dbj;
+		using namespace dbj::literals;
+
+		constexpr const char* path_ = "dbj_any_wrapper_file_test.bin";
+		constexpr dbj::GUID int_tag_ = "{6E1E2D7C-1B4A-4E63-9F0D-3C2B8A5D7E11}"_guid;
+
+		int int_arr[]{ 42, 13, 7 };
+		std::array arr_of_wraps = any::wrapper_range(int_arr);
+		arr_of_wraps[1] = any::wrapper<int>{}; // empty
+
+		bool written_ = any::write_range(path_, arr_of_wraps, int_tag_);
+		assert(written_);
+		(void)written_;
+
+		{
+			any::mapped_range<int> mapped_(path_, int_tag_);
+			assert(mapped_.valid());
+			assert(mapped_.size() == 3);
+			assert(mapped_[0].get() == 42);
+			assert(mapped_[1].empty());
+			assert(mapped_[2].get() == 7);
+
+			// wrong type is rejected
+			any::mapped_range<float> wrong_(path_);
+			assert(!wrong_.valid());
+
+			// corrupt count, (count + 7) / 8 and count * sizeof(T) would wrap
+			{
+				constexpr const char* bad_path_ = "dbj_any_wrapper_file_test_bad.bin";
+				FILE* in_ = std::fopen(path_, "rb");
+				FILE* out_ = std::fopen(bad_path_, "wb");
+				assert(in_ && out_);
+				for (int c_; (c_ = std::fgetc(in_)) != EOF;) std::fputc(c_, out_);
+				std::fclose(in_);
+				const uint64_t bad_count_ = ~0ULL;
+				std::fseek(out_, long(offsetof(any::file_header, count)), SEEK_SET);
+				std::fwrite(&bad_count_, sizeof(bad_count_), 1, out_);
+				std::fclose(out_);
+
+				errno = 0;
+				any::mapped_range<int> corrupt_(bad_path_);
+				assert(!corrupt_.valid() && errno == EINVAL && corrupt_.size() == 0);
+				std::remove(bad_path_);
+			}
+
+			printf("\n\nMapped %zu wrapped %s from %s [", mapped_.size(), DBJ_TYPE_NAME(int), path_);
+			for (auto w_ : mapped_)
+				printf(" %s", w_.empty() ? "empty" : w_.to_string().c_str());
+			printf(" ]");
+		}
+		std::remove(path_);
+	}
+} // nspace
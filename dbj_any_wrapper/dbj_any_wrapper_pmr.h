@@ -0,0 +1,273 @@
+#pragma once
+
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// dbj::any::pmr -- wrapper and wrapper_range whose memory comes
+// from the std::pmr::memory_resource given by the caller
+//
+// std::any can not be given an allocator, thus pmr::wrapper<T> keeps
+// T behind a polymorphic_allocator. Construction is uses-allocator
+// construction, so std::pmr::string and friends wrapped in here
+// allocate from the same resource. With monotonic_buffer_resource
+// a whole request worth of wrappers is released in one shot.
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "dbj_any_wrapper.h"
+
+namespace dbj {
+
+	namespace any {
+
+		namespace pmr {
+
+			template <typename T>
+			class wrapper final
+			{
+				static_assert(!std::is_reference<T>::value,
+					"[dbj::any::pmr::wrapper] Can not use a reference type");
+
+			public:
+				// types
+				typedef wrapper type;
+				typedef T data_type;
+				using allocator_type = std::pmr::polymorphic_allocator<T>;
+
+				// small values that do not allocate are kept inside,
+				// as std::any does; everything else comes from the resource
+				static constexpr bool is_inline =
+					sizeof(T) <= 2 * sizeof(void*) &&
+					std::is_trivially_copyable_v<T> &&
+					!std::uses_allocator_v<T, allocator_type>;
+
+			private:
+				allocator_type alloc_{};
+				data_type* data_{};
+				alignas(T) std::byte inline_[is_inline ? sizeof(T) : 1]{};
+
+				template <typename... Args>
+				void create(Args&&... args)
+				{
+					data_type* p_ = is_inline
+						? reinterpret_cast<data_type*>(inline_)
+						: alloc_.allocate(1);
+					// uses-allocator construction
+					if constexpr (is_inline) {
+						alloc_.construct(p_, std::forward<Args>(args)...);
+					}
+					else {
+						try {
+							alloc_.construct(p_, std::forward<Args>(args)...);
+						}
+						catch (...) {
+							alloc_.deallocate(p_, 1);
+							throw;
+						}
+					}
+					data_ = p_;
+				}
+
+				void release() noexcept
+				{
+					if (data_) {
+						data_->~data_type();
+						if constexpr (!is_inline)
+							alloc_.deallocate(data_, 1);
+						data_ = nullptr;
+					}
+				}
+
+			public:
+				wrapper() noexcept {}
+
+				explicit wrapper(allocator_type alloc_arg) noexcept
+					: alloc_(alloc_arg) {
+				}
+
+				explicit wrapper(const data_type& val_, allocator_type alloc_arg = {})
+					: alloc_(alloc_arg) {
+					create(val_);
+				}
+
+				// copy, as with all pmr types the allocator is not copied
+				wrapper(const wrapper& rhs)
+					: wrapper(rhs, allocator_type{}) {
+				}
+
+				wrapper(const wrapper& rhs, allocator_type alloc_arg)
+					: alloc_(alloc_arg) {
+					if (rhs.data_) create(*rhs.data_);
+				}
+
+				wrapper& operator=(const wrapper& x)
+				{
+					if (this != &x) {
+						if (!x.data_) release();
+						else if (data_) *data_ = *x.data_;
+						else create(*x.data_);
+					}
+					return *this;
+				}
+
+				// move, the allocator moves along
+				wrapper(wrapper&& rhs) noexcept
+					: alloc_(rhs.alloc_) {
+					if constexpr (is_inline) {
+						if (rhs.data_) create(*rhs.data_);
+					}
+					else {
+						data_ = rhs.data_;
+						rhs.data_ = nullptr;
+					}
+				}
+
+				wrapper& operator=(wrapper&& x)
+				{
+					if (this != &x) {
+						if (!is_inline && alloc_ == x.alloc_) {
+							release();
+							data_ = x.data_;
+							x.data_ = nullptr;
+						}
+						else {
+							*this = static_cast<const wrapper&>(x);
+						}
+					}
+					return *this;
+				}
+
+				~wrapper() { release(); }
+
+				allocator_type get_allocator() const noexcept { return alloc_; }
+
+				// access, no copy
+				operator data_type const& () const noexcept { return *data_; }
+
+				data_type get() const noexcept { return *data_; }
+
+				bool empty() const noexcept { return data_ == nullptr; }
+
+				const std::string to_string() const noexcept
+				{
+					return { std::to_string(*data_) };
+				}
+
+				// factory methods ----------------------------------------
+
+				// by reference, a copy of val_ would allocate from
+				// the default resource, not from alloc_arg
+				template <typename V, typename ANYW = type>
+				static auto make(const V& val_, allocator_type alloc_arg = {})
+					-> ANYW
+				{
+					static_assert(!std::is_same<const char*, std::decay_t<V>>(),
+						"dbj::any::pmr::make() can not use 'char *' pointer argument");
+
+					return ANYW{ val_, alloc_arg };
+				}
+			}; // pmr::wrapper
+
+			namespace details {
+				template <typename ANYW, typename T, std::size_t N, std::size_t... I>
+				inline auto wrapper_range(const T(&arrf)[N], std::pmr::memory_resource* mr_, std::index_sequence<I...>)
+					-> std::array<ANYW, N>
+				{
+					return { { ANYW::make(arrf[I], mr_)... } };
+				}
+			}
+
+			// as dbj::any::wrapper_range but each element, and whatever
+			// the element allocates, is in the memory given
+			template <
+				typename T,
+				std::size_t N,
+				typename ANYW = wrapper<T>,
+				typename RETT = typename std::array< ANYW, N >
+			>
+				inline auto wrapper_range(const T(&arrf)[N],
+					std::pmr::memory_resource* mr_ = std::pmr::get_default_resource())
+				-> RETT
+			{
+				return details::wrapper_range<ANYW>(arrf, mr_, std::make_index_sequence<N>{});
+			}
+		} // pmr
+	} // any
+} // dbj
+
+namespace {
+
+	inline void test_dbj_any_wrapper_pmr() noexcept
+	{
+		using namespace dbj;
+
+		std::byte buffer_[4096]{};
+		std::pmr::monotonic_buffer_resource arena_{ buffer_, sizeof(buffer_), std::pmr::null_memory_resource() };
+
+		int int_arr[]{ 42, 13, 7 };
+		auto arr_of_wraps = any::pmr::wrapper_range(int_arr, &arena_);
+		assert(arr_of_wraps[1].get() == 13);
+		assert(arr_of_wraps[1].get_allocator().resource() == &arena_);
+
+		// uses-allocator propagation into T
+		auto wrapped_str_ = any::pmr::wrapper<std::pmr::string>::make(
+			std::pmr::string("longer than small string optimization can hold"), &arena_);
+		const std::pmr::string& str_ = wrapped_str_;
+		assert(str_.get_allocator().resource() == &arena_);
+		(void)str_;
+
+		// nothing from the default resource, not even temporaries
+		{
+			std::pmr::string strs_[]{
+				{ "first string, longer than small string optimization", &arena_ },
+				{ "second string, longer than small string optimization", &arena_ } };
+			std::pmr::memory_resource* default_ = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+			auto str_wraps_ = any::pmr::wrapper_range(strs_, &arena_);
+			std::pmr::set_default_resource(default_);
+			assert(str_wraps_[1].get_allocator().resource() == &arena_);
+			(void)str_wraps_;
+		}
+
+		// the block is given back when the copy throws
+		{
+			struct counting_resource final : std::pmr::memory_resource {
+				std::size_t outstanding{};
+				void* do_allocate(std::size_t bytes_, std::size_t align_) override {
+					void* p_ = std::pmr::new_delete_resource()->allocate(bytes_, align_);
+					++outstanding;
+					return p_;
+				}
+				void do_deallocate(void* p_, std::size_t bytes_, std::size_t align_) override {
+					std::pmr::new_delete_resource()->deallocate(p_, bytes_, align_);
+					--outstanding;
+				}
+				bool do_is_equal(const std::pmr::memory_resource& other_) const noexcept override {
+					return this == &other_;
+				}
+			} counting_{};
+
+			struct throwing_copy final {
+				char payload[64]{};
+				throwing_copy() = default;
+				throwing_copy(const throwing_copy&) { throw 42; }
+			};
+
+			const throwing_copy original_{};
+			try {
+				any::pmr::wrapper<throwing_copy> wrapped_{ original_, &counting_ };
+				assert(false);
+			}
+			catch (int) {
+			}
+			assert(counting_.outstanding == 0);
+		}
+
+		printf("\n\nTransformed %s into %s, all in a %zu bytes buffer",
+			DBJ_TYPENAME(int_arr), DBJ_TYPENAME(arr_of_wraps), sizeof(buffer_));
+	}
+} // nspace
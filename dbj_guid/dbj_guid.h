@@ -12,6 +12,10 @@
 #define DJB_GUID_INC
 
 #include "../common.h"
+#include "../dbj_instrument.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
 
 
 namespace dbj {
@@ -135,6 +139,50 @@ namespace dbj {
 			return parse_guid(str + (N == long_guid_form_length ? 1 : 0));
 		}
 
+		// 16 bytes in the canonical (string) order into GUID
+		constexpr GUID guid_from_bytes(const unsigned char(&b)[16])
+		{
+			return GUID{
+				(uint32_t(b[0]) << 24) | (uint32_t(b[1]) << 16) | (uint32_t(b[2]) << 8) | uint32_t(b[3]),
+				uint16_t((b[4] << 8) | b[5]),
+				uint16_t((b[6] << 8) | b[7]),
+				{ b[8], b[9], b[10], b[11], b[12], b[13], b[14], b[15] }
+			};
+		}
+
+		// canonical 128 bit value, hi is the most significant
+		struct guid_key final {
+			uint64_t hi{};
+			uint64_t lo{};
+		};
+
+		constexpr inline guid_key to_key(const GUID& g_)
+		{
+			return guid_key{
+				(uint64_t(g_.Data1) << 32) | (uint64_t(g_.Data2) << 16) | uint64_t(g_.Data3),
+				(uint64_t(g_.Data4[0]) << 56) | (uint64_t(g_.Data4[1]) << 48) |
+				(uint64_t(g_.Data4[2]) << 40) | (uint64_t(g_.Data4[3]) << 32) |
+				(uint64_t(g_.Data4[4]) << 24) | (uint64_t(g_.Data4[5]) << 16) |
+				(uint64_t(g_.Data4[6]) << 8) | uint64_t(g_.Data4[7])
+			};
+		}
+
+		constexpr inline GUID from_key(const guid_key& k_)
+		{
+			return GUID{
+				uint32_t(k_.hi >> 32), uint16_t(k_.hi >> 16), uint16_t(k_.hi),
+				{
+					uint8_t(k_.lo >> 56), uint8_t(k_.lo >> 48), uint8_t(k_.lo >> 40), uint8_t(k_.lo >> 32),
+					uint8_t(k_.lo >> 24), uint8_t(k_.lo >> 16), uint8_t(k_.lo >> 8), uint8_t(k_.lo)
+				}
+			};
+		}
+
+		constexpr inline bool key_less(const guid_key& l_, const guid_key& r_)
+		{
+			return l_.hi < r_.hi || (l_.hi == r_.hi && l_.lo < r_.lo);
+		}
+
 		// parse char array into GUID
 		template<size_t N>
 		constexpr GUID make_guid(const char(&str)[N])
@@ -169,18 +217,26 @@ namespace {
 	/*
 	little non win portable uuid generator
 	note: works for windows too
+	note: binary form, there is no string round trip
+	note: the shared generator is not thread safe, only the
+	      seeding is; on several threads use the overload below
 	*/
 	inline dbj::GUID uuid4_guid() noexcept {
-		char string_uuid_[UUID4_LEN]{};
-		uuid4_generate(string_uuid_);
-
-		dbj::GUID win_rpc_guid_ =
-			dbj::details::make_guid_helper(
-				(const char*)string_uuid_,
-				strlen((const char*)string_uuid_)
-			);
+		unsigned char bytes_[UUID4_BYTES]{};
+		DBJ_INSTRUMENT_EVENT(uuid4_generate);
+		uuid4_generate_bytes(nullptr, bytes_);
+		return dbj::details::guid_from_bytes(bytes_);
+	}
 
-		return win_rpc_guid_;
+	/*
+	same as above but from the caller's own generator state
+	seeded by uuid4_seed_state(), one per thread is the usual scenario
+	*/
+	inline dbj::GUID uuid4_guid(uint64_t(&state_)[2]) noexcept {
+		unsigned char bytes_[UUID4_BYTES]{};
+		DBJ_INSTRUMENT_EVENT(uuid4_generate);
+		uuid4_generate_bytes(state_, bytes_);
+		return dbj::details::guid_from_bytes(bytes_);
 	}
 } //nspace
 
@@ -282,6 +338,7 @@ namespace {
 
 		dbj::GUID  guid_4 = uuid4_guid(); // internaly OS agnostic
 		assert(guid_1 != guid_4);
+		(void)guid_4;
 
 	}
 
@@ -0,0 +1,279 @@
+#pragma once
+
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// dbj guid algorithms -- bulk operations on contiguous arrays of dbj::GUID
+//
+// find / count          -- linear, rejecting on the first 32 bits
+// less                  -- canonical order, the same as the string form order
+// sort                  -- LSD radix sort on the canonical 128 bit value
+//                          optionally on several threads for large inputs
+// unique                -- on sorted input, same contract as std::unique
+// set_intersection      -- on sorted inputs, same contract as the std:: ones
+// set_difference
+//
+// all of them take [first_, last_) pointer ranges
+#include <cstddef>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DBJ_GUID_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#include "dbj_guid.h"
+
+namespace dbj {
+
+	static_assert(sizeof(GUID) == 16, "[dbj::GUID] bulk algorithms require GUID without padding");
+
+	namespace details {
+
+		// runtime equality, single 128 bit compare
+		inline bool fast_equal(const GUID& l_, const GUID& r_) noexcept
+		{
+#ifdef DBJ_GUID_SSE2
+			const __m128i a_ = _mm_loadu_si128((const __m128i*)&l_);
+			const __m128i b_ = _mm_loadu_si128((const __m128i*)&r_);
+			return _mm_movemask_epi8(_mm_cmpeq_epi8(a_, b_)) == 0xFFFF;
+#else
+			return std::memcmp(&l_, &r_, sizeof(GUID)) == 0;
+#endif
+		}
+
+		// LSD radix sort on the high 64 bits, 11 bits per pass, lowest first
+		// passes where every key has the same digit are skipped
+		// keys with equal high halves (for random GUIDs that is in practice
+		// only duplicates) are then put in order by the low half
+		inline void radix_sort_keys(guid_key* keys_, guid_key* tmp_, std::size_t count_)
+		{
+			constexpr int bits_ = 11;
+			constexpr int radix_ = 1 << bits_;
+			constexpr int passes_ = (64 + bits_ - 1) / bits_;
+			std::vector<std::size_t> hist_(passes_ * radix_, 0);
+
+			auto digit_ = [](const guid_key& k_, int pass_) -> unsigned {
+				return unsigned(k_.hi >> (pass_ * bits_)) & (radix_ - 1);
+			};
+
+			for (std::size_t j = 0; j < count_; ++j)
+				for (int p = 0; p < passes_; ++p)
+					++hist_[p * radix_ + digit_(keys_[j], p)];
+
+			guid_key* src_ = keys_;
+			guid_key* dst_ = tmp_;
+
+			for (int p = 0; p < passes_; ++p) {
+				std::size_t* h_ = &hist_[p * radix_];
+				if (h_[digit_(src_[0], p)] == count_)
+					continue; // all the same
+
+				std::size_t sum_{ 0 };
+				for (int d = 0; d < radix_; ++d) {
+					const std::size_t c_ = h_[d];
+					h_[d] = sum_;
+					sum_ += c_;
+				}
+				for (std::size_t j = 0; j < count_; ++j)
+					dst_[h_[digit_(src_[j], p)]++] = src_[j];
+
+				std::swap(src_, dst_);
+			}
+
+			if (src_ != keys_)
+				std::memcpy(keys_, src_, count_ * sizeof(guid_key));
+
+			// runs of equal high halves, by the low half
+			for (std::size_t j = 0; j < count_;) {
+				std::size_t end_ = j + 1;
+				while (end_ < count_ && keys_[end_].hi == keys_[j].hi)
+					++end_;
+				if (end_ - j > 1)
+					std::sort(keys_ + j, keys_ + end_,
+						[](const guid_key& l_, const guid_key& r_) { return l_.lo < r_.lo; });
+				j = end_;
+			}
+		}
+
+		constexpr inline std::size_t radix_sort_threshold = 512;
+
+		// sorts [first_, last_) single threaded
+		inline void radix_sort(GUID* first_, GUID* last_)
+		{
+			const std::size_t count_ = std::size_t(last_ - first_);
+			if (count_ < 2) return;
+
+			std::vector<guid_key> keys_(count_);
+			for (std::size_t j = 0; j < count_; ++j)
+				keys_[j] = to_key(first_[j]);
+
+			// histograms do not pay off for small arrays
+			if (count_ < radix_sort_threshold) {
+				std::sort(keys_.begin(), keys_.end(), key_less);
+			}
+			else {
+				std::vector<guid_key> tmp_(count_);
+				radix_sort_keys(keys_.data(), tmp_.data(), count_);
+			}
+
+			for (std::size_t j = 0; j < count_; ++j)
+				first_[j] = from_key(keys_[j]);
+		}
+	} // details
+
+	// canonical order, usable at compile time
+	constexpr inline bool less(const GUID& left_, const GUID& right_)
+	{
+		return details::key_less(details::to_key(left_), details::to_key(right_));
+	}
+
+	// first element equal to what_, or last_
+	// random GUIDs differ in Data1, dbj::equal rejects on that one
+	// compare and the branch is well predicted; the std lib loop is
+	// unrolled on top of it. 128 bit SIMD compares measured slower.
+	inline const GUID* find(const GUID* first_, const GUID* last_, const GUID& what_) noexcept
+	{
+		return std::find_if(first_, last_,
+			[&](const GUID& g_) { return dbj::equal(g_, what_); });
+	}
+
+	inline std::size_t count(const GUID* first_, const GUID* last_, const GUID& what_) noexcept
+	{
+		return std::size_t(std::count_if(first_, last_,
+			[&](const GUID& g_) { return dbj::equal(g_, what_); }));
+	}
+
+	// under this size threads do not pay off
+	constexpr inline std::size_t parallel_sort_threshold = 1 << 16;
+
+	// threads_ == 0 means std::thread::hardware_concurrency()
+	inline void sort(GUID* first_, GUID* last_, unsigned threads_ = 1)
+	{
+		const std::size_t count_ = std::size_t(last_ - first_);
+
+		if (threads_ == 0)
+			threads_ = std::max(1u, std::thread::hardware_concurrency());
+		if (threads_ == 1 || count_ < parallel_sort_threshold) {
+			details::radix_sort(first_, last_);
+			return;
+		}
+
+		// each thread sorts its chunk, then chunks are merged pairwise
+		std::vector<GUID*> bounds_(threads_ + 1);
+		for (unsigned t = 0; t <= threads_; ++t)
+			bounds_[t] = first_ + (count_ * t) / threads_;
+
+		{
+			std::vector<std::thread> workers_;
+			for (unsigned t = 0; t < threads_; ++t)
+				workers_.emplace_back(details::radix_sort, bounds_[t], bounds_[t + 1]);
+			for (auto& w : workers_) w.join();
+		}
+
+		auto guid_less_ = [](const GUID& l_, const GUID& r_) { return less(l_, r_); };
+
+		for (std::size_t width_ = 1; width_ < threads_; width_ *= 2) {
+			std::vector<std::thread> workers_;
+			for (std::size_t t = 0; t + width_ < threads_; t += 2 * width_) {
+				GUID* lo_ = bounds_[t];
+				GUID* mid_ = bounds_[t + width_];
+				GUID* hi_ = bounds_[std::min<std::size_t>(t + 2 * width_, threads_)];
+				workers_.emplace_back([=] { std::inplace_merge(lo_, mid_, hi_, guid_less_); });
+			}
+			for (auto& w : workers_) w.join();
+		}
+	}
+
+	// on sorted input, returns the new end
+	inline GUID* unique(GUID* first_, GUID* last_) noexcept
+	{
+		if (first_ == last_) return last_;
+
+		GUID* out_ = first_;
+		while (++first_ != last_)
+			if (!details::fast_equal(*out_, *first_))
+				*++out_ = *first_;
+		return ++out_;
+	}
+
+	// on sorted inputs, returns the end of the output
+	inline GUID* set_intersection(
+		const GUID* first1_, const GUID* last1_,
+		const GUID* first2_, const GUID* last2_,
+		GUID* out_) noexcept
+	{
+		while (first1_ != last1_ && first2_ != last2_) {
+			const auto k1_ = details::to_key(*first1_);
+			const auto k2_ = details::to_key(*first2_);
+			if (details::key_less(k1_, k2_)) ++first1_;
+			else if (details::key_less(k2_, k1_)) ++first2_;
+			else { *out_++ = *first1_++; ++first2_; }
+		}
+		return out_;
+	}
+
+	// elements of the first range not found in the second one
+	inline GUID* set_difference(
+		const GUID* first1_, const GUID* last1_,
+		const GUID* first2_, const GUID* last2_,
+		GUID* out_) noexcept
+	{
+		while (first1_ != last1_ && first2_ != last2_) {
+			const auto k1_ = details::to_key(*first1_);
+			const auto k2_ = details::to_key(*first2_);
+			if (details::key_less(k1_, k2_)) *out_++ = *first1_++;
+			else if (details::key_less(k2_, k1_)) ++first2_;
+			else { ++first1_; ++first2_; }
+		}
+		while (first1_ != last1_)
+			*out_++ = *first1_++;
+		return out_;
+	}
+} // dbj
+
+namespace {
+
+	inline void test_dbj_guid_algo() noexcept
+	{
+		using namespace dbj::literals;
+
+		constexpr dbj::GUID guid_a = "{00000000-0000-0000-0000-000000000001}"_guid;
+		constexpr dbj::GUID guid_b = "{00000000-0000-0000-0000-000000000100}"_guid;
+		constexpr dbj::GUID guid_c = "{FE297330-BAA5-407F-BB47-F78752D2C209}"_guid;
+
+		static_assert(dbj::less(guid_a, guid_b));
+		static_assert(dbj::less(guid_b, guid_c));
+		static_assert(dbj::details::from_key(dbj::details::to_key(guid_c)) == guid_c);
+
+		dbj::GUID arr_[]{ guid_c, guid_a, guid_b, guid_c, guid_a };
+		auto* end_ = arr_ + 5;
+
+		assert(dbj::count(arr_, end_, guid_c) == 2);
+		assert(dbj::find(arr_, end_, guid_b) == arr_ + 2);
+
+		dbj::sort(arr_, end_);
+		assert(arr_[0] == guid_a && arr_[2] == guid_b && arr_[4] == guid_c);
+
+		end_ = dbj::unique(arr_, end_);
+		assert(end_ - arr_ == 3);
+
+		dbj::GUID other_[]{ guid_b, guid_c };
+		dbj::GUID out_[3]{};
+		assert(dbj::set_intersection(arr_, end_, other_, other_ + 2, out_) - out_ == 2);
+		assert(dbj::set_difference(arr_, end_, other_, other_ + 2, out_) - out_ == 1);
+		assert(out_[0] == guid_a);
+		(void)other_; (void)out_;
+
+		// large enough for the threads
+		std::vector<dbj::GUID> many_(dbj::parallel_sort_threshold * 2);
+		for (auto& g : many_) g = uuid4_guid();
+		dbj::sort(many_.data(), many_.data() + many_.size(), 4);
+		assert(std::is_sorted(many_.begin(), many_.end(),
+			[](auto const& l_, auto const& r_) { return dbj::less(l_, r_); }));
+
+		printf("\nSorted %zu GUIDs", many_.size());
+	}
+} // nspace
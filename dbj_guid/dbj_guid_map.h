@@ -0,0 +1,226 @@
+#pragma once
+
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// dbj guid map -- compile time perfect hash of a fixed set of GUIDs
+//
+// usage:
+//   using namespace dbj::literals;
+//   constexpr auto ids_ = dbj::make_guid_map({
+//       "{FE297330-BAA5-407F-BB47-F78752D2C209}"_guid,
+//       "{2E1F8A59-7C43-4D5B-9C9A-0B6E2D1F3A44}"_guid
+//   });
+//   std::size_t idx_ = ids_.find(runtime_guid_); // 0, 1 or ids_.npos
+//
+// hash and displace: the first hash selects a bucket and its displacement,
+// the displacement selects the slot, the slot holds the index and the key
+// to compare; thus exactly three table reads per lookup, found or not
+//
+// the whole table is built by the compiler and lives in read only data
+// duplicate GUIDs are rejected at compile time; made at runtime, the
+// map finds nothing and errno is set to EINVAL, we do not exit
+#include <stddef.h>
+#include "dbj_guid.h"
+
+namespace dbj {
+
+	namespace details {
+
+		// splitmix64 finalizer
+		constexpr inline uint64_t guid_mix(uint64_t x_)
+		{
+			x_ ^= x_ >> 30; x_ *= 0xbf58476d1ce4e5b9ULL;
+			x_ ^= x_ >> 27; x_ *= 0x94d049bb133111ebULL;
+			x_ ^= x_ >> 31;
+			return x_;
+		}
+
+		constexpr inline uint64_t guid_hash(const guid_key& k_)
+		{
+			return guid_mix(k_.hi ^ (k_.lo * 0x9e3779b97f4a7c15ULL));
+		}
+
+		constexpr inline size_t next_pow2(size_t n_)
+		{
+			size_t p_ = 1;
+			while (p_ < n_) p_ <<= 1;
+			return p_;
+		}
+
+		constexpr inline uint32_t guid_slot(uint64_t hash_, uint32_t displacement_, size_t mask_)
+		{
+			const uint32_t f1_ = uint32_t(hash_ >> 32);
+			const uint32_t f2_ = uint32_t(hash_ >> 16) | 1u;
+			return uint32_t((f1_ + displacement_ * f2_) & mask_);
+		}
+	} // details
+
+	template <size_t N>
+	class guid_map final
+	{
+		static_assert(N > 0, "[dbj::guid_map] can not be empty");
+
+	public:
+		using type = guid_map;
+		static constexpr size_t npos = size_t(-1);
+
+		// buckets, load of the slots table is at most 1/2
+		static constexpr size_t bucket_count = details::next_pow2(N);
+		static constexpr size_t slot_count = 2 * bucket_count;
+
+	private:
+		static constexpr uint32_t empty_ = uint32_t(-1);
+		static constexpr uint32_t max_displacement_ = 1u << 16;
+
+		uint32_t displacement_[bucket_count]{};
+		uint32_t index_[slot_count]{};
+		details::guid_key keys_[slot_count]{};
+
+		template <size_t M>
+		friend constexpr guid_map<M> make_guid_map(const GUID(&)[M]);
+
+		constexpr guid_map() = default;
+
+		// not constexpr, thus a compile time error when constant evaluated
+		void fail(const char* why_) noexcept
+		{
+			for (auto& ix_ : index_) ix_ = empty_;
+			errno = EINVAL;
+			perror(why_);
+		}
+
+		constexpr void build(const GUID(&guids_)[N])
+		{
+			using namespace details;
+
+			guid_key keys_in_[N]{};
+			uint64_t hash_[N]{};
+			for (size_t j = 0; j < N; ++j) {
+				keys_in_[j] = to_key(guids_[j]);
+				hash_[j] = guid_hash(keys_in_[j]);
+			}
+
+			for (size_t j = 0; j < N; ++j)
+				for (size_t k = j + 1; k < N; ++k)
+					if (keys_in_[j].hi == keys_in_[k].hi && keys_in_[j].lo == keys_in_[k].lo)
+						return fail(__FILE__ " -- duplicate GUID in dbj::guid_map");
+
+			for (auto& ix_ : index_) ix_ = empty_;
+
+			// buckets, the most populated are placed first
+			size_t bucket_size_[bucket_count]{};
+			size_t order_[bucket_count]{};
+			for (size_t j = 0; j < N; ++j)
+				++bucket_size_[hash_[j] & (bucket_count - 1)];
+			for (size_t b = 0; b < bucket_count; ++b) {
+				size_t i = b;
+				for (; i > 0 && bucket_size_[order_[i - 1]] < bucket_size_[b]; --i)
+					order_[i] = order_[i - 1];
+				order_[i] = b;
+			}
+
+			for (size_t o = 0; o < bucket_count; ++o) {
+				const size_t b = order_[o];
+				if (bucket_size_[b] == 0) break;
+
+				uint32_t d_ = 0;
+				for (; d_ < max_displacement_; ++d_) {
+					bool fits_ = true;
+					uint32_t taken_[N]{};
+					size_t taken_count_ = 0;
+
+					for (size_t j = 0; j < N && fits_; ++j) {
+						if ((hash_[j] & (bucket_count - 1)) != b) continue;
+						const uint32_t s_ = guid_slot(hash_[j], d_, slot_count - 1);
+						if (index_[s_] != empty_) fits_ = false;
+						for (size_t t = 0; t < taken_count_ && fits_; ++t)
+							if (taken_[t] == s_) fits_ = false;
+						taken_[taken_count_++] = s_;
+					}
+					if (fits_) break;
+				}
+
+				if (d_ == max_displacement_)
+					return fail(__FILE__ " -- dbj::guid_map could not be built");
+
+				displacement_[b] = d_;
+				for (size_t j = 0; j < N; ++j) {
+					if ((hash_[j] & (bucket_count - 1)) != b) continue;
+					const uint32_t s_ = guid_slot(hash_[j], d_, slot_count - 1);
+					index_[s_] = uint32_t(j);
+					keys_[s_] = keys_in_[j];
+				}
+			}
+		}
+
+	public:
+		constexpr size_t size() const noexcept { return N; }
+
+		// dense index of the GUID as given to make_guid_map(), or npos
+		constexpr size_t find(const GUID& guid_) const noexcept
+		{
+			using namespace details;
+			const guid_key k_ = to_key(guid_);
+			const uint64_t h_ = guid_hash(k_);
+			const uint32_t s_ = guid_slot(h_, displacement_[h_ & (bucket_count - 1)], slot_count - 1);
+			const uint32_t ix_ = index_[s_];
+			if (ix_ == empty_ || keys_[s_].hi != k_.hi || keys_[s_].lo != k_.lo)
+				return npos;
+			return ix_;
+		}
+
+		constexpr bool contains(const GUID& guid_) const noexcept
+		{
+			return find(guid_) != npos;
+		}
+	}; // guid_map
+
+	// must be used in a constant expression for duplicates
+	// to be reported at compile time; otherwise see errno
+	template <size_t N>
+	constexpr guid_map<N> make_guid_map(const GUID(&guids_)[N])
+	{
+		guid_map<N> map_{};
+		map_.build(guids_);
+		return map_;
+	}
+} // dbj
+
+namespace {
+
+	inline void test_dbj_guid_map() noexcept
+	{
+		using namespace dbj::literals;
+
+		constexpr dbj::GUID guid_a = "{FE297330-BAA5-407F-BB47-F78752D2C209}"_guid;
+		constexpr dbj::GUID guid_b = "{00000000-0000-0000-0000-000000000001}"_guid;
+		constexpr dbj::GUID guid_c = "{00000000-0000-0000-0000-000000000002}"_guid;
+		constexpr dbj::GUID guid_d = "{2E1F8A59-7C43-4D5B-9C9A-0B6E2D1F3A44}"_guid;
+
+		constexpr auto ids_ = dbj::make_guid_map({ guid_a, guid_b, guid_c, guid_d });
+
+		static_assert(ids_.find(guid_a) == 0);
+		static_assert(ids_.find(guid_b) == 1);
+		static_assert(ids_.find(guid_c) == 2);
+		static_assert(ids_.find(guid_d) == 3);
+		static_assert(!ids_.contains(dbj::null_guid));
+
+		// does not compile, duplicate
+		// constexpr auto bad_ = dbj::make_guid_map({ guid_a, guid_b, guid_a });
+
+		// runtime
+		assert(ids_.find(uuid4_guid()) == ids_.npos);
+		dbj::GUID runtime_b = guid_b;
+		assert(ids_.find(runtime_b) == 1);
+		(void)runtime_b;
+
+		// made at runtime, a duplicate leaves the map empty
+		const dbj::GUID with_duplicate_[]{ guid_a, guid_b, runtime_b };
+		errno = 0;
+		const auto bad_ = dbj::make_guid_map(with_duplicate_);
+		assert(errno == EINVAL && !bad_.contains(guid_a));
+		(void)bad_;
+
+		printf("\nGUID map of %zu in %zu slots", ids_.size(), ids_.slot_count);
+	}
+} // nspace
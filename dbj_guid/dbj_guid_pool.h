@@ -0,0 +1,326 @@
+#pragma once
+
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// dbj guid pool -- GUIDs generated before they are asked for
+//
+// two flavours
+// 1. dbj::guid_pool<N> -- background producer thread fills a lock free
+//    single producer / multiple consumers ring, consumers take one GUID
+//    with one CAS; producer waits when the ring is full (back pressure)
+//    and is woken up when the ring drops under the low watermark
+// 2. dbj::local_guid() -- each thread owns a cache aligned block of GUIDs
+//    and its own generator state, refilled in bulk when exhausted
+//    no atomics at all on the hand out path
+//
+// we do not use exceptions, acquire() never blocks; on empty ring the
+// consumer falls back to its local_guid() block
+// if the OS random source can not seed a generator we do not make up
+// a seed: errno is set and dbj::null_guid is handed out
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+#include "dbj_guid.h"
+
+namespace dbj {
+
+	constexpr inline std::size_t cache_line_size = 64;
+
+	namespace details {
+		// one per thread, never shared thus never contended
+		struct alignas(cache_line_size) local_guid_block final {
+			static constexpr std::size_t size = 64;
+			dbj::GUID guids[size]{};
+			std::size_t next{ size };
+			uint64_t state[2]{};
+			bool seeded{ false };
+
+			// false if the generator could not be seeded
+			bool refill() noexcept
+			{
+				if (!seeded) {
+					if (uuid4_seed_state(state) != UUID4_ESUCCESS) {
+						errno = EIO;
+						perror(__FILE__ " -- can not seed the thread local GUID generator");
+						return false;
+					}
+					seeded = true;
+				}
+				for (auto& guid_ : guids)
+					guid_ = uuid4_guid(state);
+				next = 0;
+				return true;
+			}
+		};
+	} // details
+
+	// thread local block hand out
+	// dbj::null_guid and errno set if the block can not be seeded
+	inline dbj::GUID local_guid() noexcept
+	{
+		thread_local details::local_guid_block block_{};
+		if (block_.next == details::local_guid_block::size)
+			if (!block_.refill())
+				return dbj::null_guid;
+		return block_.guids[block_.next++];
+	}
+
+	template <std::size_t CAPACITY = 4096>
+	class guid_pool final
+	{
+		static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+			"[dbj::guid_pool] CAPACITY must be a power of 2");
+
+		static constexpr std::size_t mask_ = CAPACITY - 1;
+		// producer generates this many before publishing
+		static constexpr std::size_t batch_ = 64;
+
+		// Vyukov bounded queue cell; seq tells who owns the cell
+		struct cell final {
+			std::atomic<std::size_t> seq{};
+			dbj::GUID guid{};
+		};
+
+		alignas(cache_line_size) std::atomic<std::size_t> head_{ 0 }; // consumers
+		alignas(cache_line_size) std::atomic<std::size_t> tail_{ 0 }; // producer
+		alignas(cache_line_size) std::atomic<bool> refill_requested_{ false };
+		std::atomic<bool> running_{ true };
+		alignas(cache_line_size) cell cells_[CAPACITY]{};
+
+		std::size_t low_watermark_{};
+		uint64_t state_[2]{}; // producer's own generator
+		std::mutex wake_mx_{};
+		std::condition_variable wake_{};
+		std::thread producer_{};
+
+		// producer only
+		bool push(const dbj::GUID& guid_) noexcept
+		{
+			const std::size_t pos_ = tail_.load(std::memory_order_relaxed);
+			cell& cell_ = cells_[pos_ & mask_];
+			if (cell_.seq.load(std::memory_order_acquire) != pos_)
+				return false; // full
+			cell_.guid = guid_;
+			cell_.seq.store(pos_ + 1, std::memory_order_release);
+			tail_.store(pos_ + 1, std::memory_order_release);
+			return true;
+		}
+
+		void produce() noexcept
+		{
+			dbj::GUID batch_guids_[batch_]{};
+			std::size_t ready_{ 0 }, published_{ 0 };
+
+			while (running_.load(std::memory_order_relaxed)) {
+				if (published_ == ready_) {
+					for (auto& guid_ : batch_guids_)
+						guid_ = uuid4_guid(state_);
+					ready_ = batch_; published_ = 0;
+				}
+				while (published_ < ready_ && push(batch_guids_[published_]))
+					++published_;
+
+				if (published_ < ready_) {
+					// full, sleep until under the low watermark
+					refill_requested_.store(false, std::memory_order_relaxed);
+					std::unique_lock<std::mutex> lock_(wake_mx_);
+					wake_.wait_for(lock_, std::chrono::milliseconds(10), [&] {
+						return !running_.load(std::memory_order_relaxed)
+							|| refill_requested_.load(std::memory_order_relaxed);
+						});
+				}
+			}
+		}
+
+	public:
+		using type = guid_pool;
+		static constexpr std::size_t capacity = CAPACITY;
+		// how many acquire() takes from the ring at once
+		static constexpr std::size_t cache_size = CAPACITY < 16 ? 1 : 16;
+
+		explicit guid_pool(std::size_t low_watermark_arg = CAPACITY / 4) noexcept
+			: low_watermark_(low_watermark_arg < CAPACITY ? low_watermark_arg : CAPACITY / 4)
+		{
+			for (std::size_t j = 0; j < CAPACITY; ++j)
+				cells_[j].seq.store(j, std::memory_order_relaxed);
+
+			// no producer when not seeded, the ring stays empty
+			// and acquire() reports through local_guid()
+			if (uuid4_seed_state(state_) != UUID4_ESUCCESS) {
+				errno = EIO;
+				perror(__FILE__ " -- can not seed the GUID pool generator");
+				return;
+			}
+			producer_ = std::thread([this] { produce(); });
+		}
+
+		~guid_pool()
+		{
+			running_.store(false, std::memory_order_relaxed);
+			{
+				std::lock_guard<std::mutex> lock_(wake_mx_);
+			}
+			wake_.notify_one();
+			if (producer_.joinable())
+				producer_.join();
+		}
+
+		guid_pool(guid_pool const&) = delete;
+		guid_pool& operator = (guid_pool const&) = delete;
+		guid_pool(guid_pool&&) = delete;
+		guid_pool& operator = (guid_pool&&) = delete;
+
+		// how many are ready, approximately
+		std::size_t size() const noexcept
+		{
+			const std::size_t tail_val_ = tail_.load(std::memory_order_acquire);
+			const std::size_t head_val_ = head_.load(std::memory_order_acquire);
+			return tail_val_ > head_val_ ? tail_val_ - head_val_ : 0;
+		}
+
+		// false if the ring is empty
+		bool try_acquire(dbj::GUID& guid_) noexcept
+		{
+			std::size_t pos_ = head_.load(std::memory_order_relaxed);
+			for (;;) {
+				cell& cell_ = cells_[pos_ & mask_];
+				const std::size_t seq_ = cell_.seq.load(std::memory_order_acquire);
+				const std::ptrdiff_t diff_ = (std::ptrdiff_t)seq_ - (std::ptrdiff_t)(pos_ + 1);
+
+				if (diff_ == 0) {
+					if (head_.compare_exchange_weak(pos_, pos_ + 1, std::memory_order_relaxed)) {
+						guid_ = cell_.guid;
+						cell_.seq.store(pos_ + CAPACITY, std::memory_order_release);
+						break;
+					}
+				}
+				else if (diff_ < 0) {
+					request_refill();
+					return false;
+				}
+				else {
+					pos_ = head_.load(std::memory_order_relaxed);
+				}
+			}
+
+			// once per batch, is the cell low_watermark_ ahead filled;
+			// thus no reading of the producer's tail_ on every hand out
+			if ((pos_ % batch_) == 0) {
+				const std::size_t ahead_ = pos_ + low_watermark_;
+				if (cells_[ahead_ & mask_].seq.load(std::memory_order_relaxed) != ahead_ + 1)
+					request_refill();
+			}
+			return true;
+		}
+
+		// false if there are not n_ ready, thus all or nothing
+		// one CAS for all of them
+		bool try_acquire(dbj::GUID* guids_, std::size_t n_) noexcept
+		{
+			if (n_ == 0 || n_ > CAPACITY) return false;
+
+			std::size_t pos_ = head_.load(std::memory_order_relaxed);
+			for (;;) {
+				// the producer publishes in order, last one ready means all are
+				cell& last_ = cells_[(pos_ + n_ - 1) & mask_];
+				const std::size_t seq_ = last_.seq.load(std::memory_order_acquire);
+				const std::ptrdiff_t diff_ = (std::ptrdiff_t)seq_ - (std::ptrdiff_t)(pos_ + n_);
+
+				if (diff_ == 0) {
+					if (head_.compare_exchange_weak(pos_, pos_ + n_, std::memory_order_relaxed))
+						break;
+				}
+				else if (diff_ < 0) {
+					request_refill();
+					return false;
+				}
+				else {
+					pos_ = head_.load(std::memory_order_relaxed);
+				}
+			}
+
+			for (std::size_t j = 0; j < n_; ++j) {
+				cell& cell_ = cells_[(pos_ + j) & mask_];
+				guids_[j] = cell_.guid;
+				cell_.seq.store(pos_ + j + CAPACITY, std::memory_order_release);
+			}
+
+			const std::size_t ahead_ = pos_ + n_ + low_watermark_;
+			if (cells_[ahead_ & mask_].seq.load(std::memory_order_relaxed) != ahead_ + 1)
+				request_refill();
+			return true;
+		}
+
+		// never fails, never blocks
+		// GUIDs are taken from the ring in batches of cache_size, into the
+		// caller's thread cache, thus one CAS per cache_size hand outs
+		// on empty ring hands out from the caller's local_guid() block
+		// note: the thread cache is shared by the pools of the same CAPACITY
+		// they are all uuid4 GUIDs, each one is handed out only once
+		dbj::GUID acquire() noexcept
+		{
+			struct thread_cache final {
+				dbj::GUID guids[cache_size]{};
+				std::size_t next{ cache_size };
+			};
+			thread_local thread_cache cache_{};
+
+			if (cache_.next < cache_size)
+				return cache_.guids[cache_.next++];
+
+			if (try_acquire(cache_.guids, cache_size)) {
+				cache_.next = 1;
+				return cache_.guids[0];
+			}
+
+			dbj::GUID guid_{};
+			if (try_acquire(guid_))
+				return guid_;
+			return local_guid();
+		}
+
+	private:
+		// only the first consumer under the watermark pays for the notify
+		void request_refill() noexcept
+		{
+			if (!refill_requested_.load(std::memory_order_relaxed) &&
+				!refill_requested_.exchange(true, std::memory_order_relaxed))
+				wake_.notify_one();
+		}
+	}; // guid_pool
+} // dbj
+
+namespace {
+
+	inline void test_dbj_guid_pool() noexcept
+	{
+		dbj::guid_pool<256> pool_{};
+
+		dbj::GUID first_ = pool_.acquire();
+		dbj::GUID second_ = pool_.acquire();
+		assert(first_ != second_);
+		assert(first_ != dbj::null_guid);
+		(void)first_; (void)second_;
+
+		// all or nothing
+		dbj::GUID batch_[8]{};
+		if (pool_.try_acquire(batch_, 8))
+			assert(batch_[0] != batch_[7] && batch_[7] != dbj::null_guid);
+		assert(!pool_.try_acquire(batch_, pool_.capacity + 1));
+
+		// drain more than the capacity, consumers never block
+		for (int j = 0; j < 1024; ++j)
+			assert(pool_.acquire() != first_);
+
+		dbj::GUID local_1 = dbj::local_guid();
+		dbj::GUID local_2 = dbj::local_guid();
+		assert(local_1 != local_2);
+		(void)local_1; (void)local_2;
+
+		printf("\nGUID pool of %zu, ready: %zu", pool_.capacity, pool_.size());
+	}
+} // nspace
@@ -5,6 +5,10 @@
  * under the terms of the MIT license. See LICENSE for details.
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* syscall() */
+#endif
+
 #include <stdio.h>
 #include <stdint.h>
 
@@ -13,6 +17,13 @@
 #define STRICT 1
 #include <windows.h>
 #include <wincrypt.h>
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif // __linux__
 #endif // _WIN32
 
 #include "uuid4.h"
@@ -38,18 +49,54 @@ extern "C" {
 	}
 
 
-	int uuid4_init(void) {
+	/*
+	DBJ: seeding is lazy and happens only once per process
+	     no I/O is done until the first uuid is requested
+	     (or until uuid4_init() is called explicitly)
+	*/
+	static int seed_status_ = UUID4_EFAILURE;
+	/* read from any thread, thus published with release / acquire */
+	static long seeded_ = 0;
+
+#if defined(_WIN32)
+	static void uuid4_publish_seeded(void) { InterlockedExchange(&seeded_, 1); }
+	static long uuid4_read_seeded(void) { return InterlockedCompareExchange(&seeded_, 0, 0); }
+#else
+	static void uuid4_publish_seeded(void) { __atomic_store_n(&seeded_, 1, __ATOMIC_RELEASE); }
+	static long uuid4_read_seeded(void) { return __atomic_load_n(&seeded_, __ATOMIC_ACQUIRE); }
+#endif // _WIN32
+
+#define UUID4_SEED_SIZE (2 * sizeof(uint64_t))
+
 #if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
-		int res;
+	static int urandom_seed(uint64_t dst[2]) {
+		size_t res;
 		FILE* fp = fopen("/dev/urandom", "rb");
 		if (!fp) {
 			return UUID4_EFAILURE;
 		}
-		res = fread(seed, 1, sizeof(seed), fp);
+		res = fread(dst, 1, UUID4_SEED_SIZE, fp);
 		fclose(fp);
-		if (res != sizeof(seed)) {
+		if (res != UUID4_SEED_SIZE) {
 			return UUID4_EFAILURE;
 		}
+		return UUID4_ESUCCESS;
+	}
+#endif
+
+	static int uuid4_seed(uint64_t dst[2]) {
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+#if defined(SYS_getrandom)
+		/* one syscall, no file descriptor; /dev/urandom if kernel is too old */
+		long res;
+		do {
+			res = syscall(SYS_getrandom, dst, UUID4_SEED_SIZE, 0);
+		} while (res < 0 && errno == EINTR);
+		if (res == (long)UUID4_SEED_SIZE) {
+			return UUID4_ESUCCESS;
+		}
+#endif // SYS_getrandom
+		return urandom_seed(dst);
 
 #elif defined(_WIN32)
 		int res;
@@ -59,18 +106,69 @@ extern "C" {
 		if (!res) {
 			return UUID4_EFAILURE;
 		}
-		res = CryptGenRandom(hCryptProv, (DWORD)sizeof(seed), (PBYTE)seed);
+		res = CryptGenRandom(hCryptProv, (DWORD)UUID4_SEED_SIZE, (PBYTE)dst);
 		CryptReleaseContext(hCryptProv, 0);
 		if (!res) {
 			return UUID4_EFAILURE;
 		}
-
+		return UUID4_ESUCCESS;
 #else
 #error "unsupported platform"
 #endif
-		return UUID4_ESUCCESS;
-		}
+	}
+
+#if defined(_WIN32)
+	static INIT_ONCE seed_once_ = INIT_ONCE_STATIC_INIT;
+
+	static BOOL CALLBACK uuid4_seed_once(PINIT_ONCE once_, PVOID param_, PVOID* context_) {
+		(void)once_; (void)param_; (void)context_;
+		seed_status_ = uuid4_seed(seed);
+		uuid4_publish_seeded();
+		return TRUE;
+	}
+
+	int uuid4_init(void) {
+		InitOnceExecuteOnce(&seed_once_, uuid4_seed_once, NULL, NULL);
+		return seed_status_;
+	}
+#else
+	static pthread_once_t seed_once_ = PTHREAD_ONCE_INIT;
 
+	static void uuid4_seed_once(void) {
+		seed_status_ = uuid4_seed(seed);
+		uuid4_publish_seeded();
+	}
+
+	int uuid4_init(void) {
+		pthread_once(&seed_once_, uuid4_seed_once);
+		return seed_status_;
+	}
+#endif // _WIN32
+
+	int uuid4_is_seeded(void) {
+		return uuid4_read_seeded() != 0;
+	}
+
+	int uuid4_seed_state(uint64_t state[2]) {
+		return uuid4_seed(state);
+	}
+
+	void uuid4_generate_bytes(uint64_t state[2], unsigned char dst[UUID4_BYTES])
+	{
+		union { unsigned char b[16]; uint64_t word[2]; } s;
+		int i;
+		if (!state) {
+			uuid4_init();
+			state = seed;
+		}
+		s.word[0] = xorshift128plus(state);
+		s.word[1] = xorshift128plus(state);
+		for (i = 0; i < UUID4_BYTES; ++i)
+			dst[i] = s.b[i];
+		/* version 4, variant 10xx -- same as the string form */
+		dst[6] = (unsigned char)((dst[6] & 0x0f) | 0x40);
+		dst[8] = (unsigned char)((dst[8] & 0x3f) | 0x80);
+	}
 
 	void uuid4_generate(char dst[UUID4_LEN])
 	{
@@ -79,6 +177,8 @@ extern "C" {
 		union { unsigned char b[16]; uint64_t word[2]; } s;
 		const char* p;
 		int i, n;
+		/* seed on first use */
+		uuid4_init();
 		/* get random */
 		s.word[0] = xorshift128plus(seed);
 		s.word[1] = xorshift128plus(seed);
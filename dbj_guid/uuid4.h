@@ -15,6 +15,7 @@
 int main(void) {
   char buf[UUID4_LEN];
 
+  // optional: generator seeds itself, once, on first use
   uuid4_init();
   uuid4_generate(buf);
   printf("%s\n", buf);
@@ -26,6 +27,9 @@ int main(void) {
 
 #define UUID4_VERSION "1.0.0"
 #define UUID4_LEN 37
+#define UUID4_BYTES 16
+
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -36,20 +40,23 @@ extern "C" {
         UUID4_EFAILURE = -1
     } UUID4_STATUS ;
 
+    // thread safe, seeds only once, further calls return the first result
     int  uuid4_init(void);
+    // 1 if seeding has already happened, 0 otherwise; from any thread
+    int  uuid4_is_seeded(void);
+    // shared generator, not thread safe
     void uuid4_generate(char dst[UUID4_LEN]);
 
-#ifdef __cplusplus
-} // extern "C" 
-#endif // __cplusplus
+    // binary form, no string round trip
+    // state == NULL uses the shared, lazily seeded process generator
+    // only the seeding of it is thread safe, generating is not
+    // otherwise state is private to the caller, seeded by uuid4_seed_state()
+    // a private state is not shared thus not contended between threads
+    int  uuid4_seed_state(uint64_t state[2]);
+    void uuid4_generate_bytes(uint64_t state[2], unsigned char dst[UUID4_BYTES]);
 
 #ifdef __cplusplus
-// C++ makes this possible
-namespace {
-    // note: can this ever fail?
-    inline auto uuid4_init_cpp = []() { return uuid4_init(); }();
-}
+} // extern "C" 
 #endif // __cplusplus
 
-
 #endif
\ No newline at end of file
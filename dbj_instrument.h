@@ -0,0 +1,448 @@
+#pragma once
+
+// (c) 2021 by dbj@dbj.org CC BY SA 4.0
+
+// dbj instrument -- what do wrappers, GUIDs and stores cost us
+//
+// opt in, at compile time, for the whole program:
+//
+//   #define DBJ_INSTRUMENT 1   // or -DDBJ_INSTRUMENT=1
+//
+// it must be the same in every translation unit. When not defined
+// the hooks are ((void)0) and the snapshot is all zeros.
+//
+// counted:
+//   dbj::any::wrapper copies, moves, heap allocations and any_cast's
+//   dbj::data lock acquisitions, contention and hold time, per store GUID
+//     (contention and hold time are measured on every hold_sample_period-th
+//     acquisition and extrapolated; a try_lock() probe and reading the
+//     clock cost more than the lock itself)
+//   uuid4_guid() generations
+//
+// each thread counts into its own cache aligned block, with no locked
+// instructions; take_snapshot() sums the blocks of the live threads and
+// whatever the finished threads left behind
+//
+// usage:
+//   auto before_ = dbj::instrument::take_snapshot();
+//   ...
+//   dbj::instrument::print_json(stdout, dbj::instrument::delta(dbj::instrument::take_snapshot(), before_));
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+#ifndef DBJ_INSTRUMENT
+#define DBJ_INSTRUMENT 0
+#endif
+
+#if DBJ_INSTRUMENT
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define DBJ_INSTRUMENT_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define DBJ_INSTRUMENT_RDTSC
+#endif
+
+#define DBJ_INSTRUMENT_EVENT(E) ::dbj::instrument::count(::dbj::instrument::event::E, 1)
+#define DBJ_INSTRUMENT_ADD(E, N) ::dbj::instrument::count(::dbj::instrument::event::E, N)
+#else
+#define DBJ_INSTRUMENT_EVENT(E) ((void)0)
+#define DBJ_INSTRUMENT_ADD(E, N) ((void)0)
+#endif // DBJ_INSTRUMENT
+
+namespace dbj {
+
+	namespace instrument {
+
+		constexpr inline bool enabled = DBJ_INSTRUMENT != 0;
+
+		enum class event : unsigned {
+			wrapper_copy,
+			wrapper_move,
+			wrapper_heap_alloc,
+			wrapper_any_cast,
+			uuid4_generate,
+			count_
+		};
+
+		constexpr inline unsigned event_count = unsigned(event::count_);
+
+		constexpr inline const char* event_names[event_count]{
+			"wrapper_copy",
+			"wrapper_move",
+			"wrapper_heap_alloc",
+			"wrapper_any_cast",
+			"uuid4_generate"
+		};
+
+		// power of 2
+		constexpr inline unsigned hold_sample_period = 64;
+
+		// stores beyond this many are not counted
+		constexpr inline unsigned max_stores = 32;
+
+		// {XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX}
+		constexpr inline unsigned guid_text_size = 39;
+
+		struct store_stats final {
+			char guid[guid_text_size];
+			uint64_t acquisitions;
+			uint64_t contended;
+			uint64_t hold_ns;
+		};
+
+		struct snapshot final {
+			double seconds;     // since the first instrumented event
+			unsigned threads;   // counting threads, alive at the time
+			uint64_t events[event_count];
+			unsigned store_count;
+			store_stats stores[max_stores];
+		};
+
+		// what happened between the two
+		inline snapshot delta(const snapshot& later_, const snapshot& earlier_) noexcept
+		{
+			snapshot d_ = later_;
+			d_.seconds = later_.seconds - earlier_.seconds;
+			for (unsigned e = 0; e < event_count; ++e)
+				d_.events[e] -= earlier_.events[e];
+			// stores are never removed, slot j is the same store in both
+			for (unsigned j = 0; j < earlier_.store_count && j < d_.store_count; ++j) {
+				d_.stores[j].acquisitions -= earlier_.stores[j].acquisitions;
+				d_.stores[j].contended -= earlier_.stores[j].contended;
+				d_.stores[j].hold_ns -= earlier_.stores[j].hold_ns;
+			}
+			return d_;
+		}
+
+		inline double uuid4_per_second(const snapshot& s_) noexcept
+		{
+			return s_.seconds > 0 ? double(s_.events[unsigned(event::uuid4_generate)]) / s_.seconds : 0.0;
+		}
+
+		inline void print_text(FILE* fp_, const snapshot& s_) noexcept
+		{
+			fprintf(fp_, "\ndbj instrument %s, %.3f s, %u threads",
+				enabled ? "snapshot" : "is disabled", s_.seconds, s_.threads);
+			for (unsigned e = 0; e < event_count; ++e)
+				fprintf(fp_, "\n  %-20s %12llu", event_names[e], (unsigned long long)s_.events[e]);
+			fprintf(fp_, "\n  %-20s %12.0f", "uuid4_per_second", uuid4_per_second(s_));
+			for (unsigned j = 0; j < s_.store_count; ++j)
+				fprintf(fp_, "\n  store %s acquisitions %llu contended %llu hold %llu ns",
+					s_.stores[j].guid,
+					(unsigned long long)s_.stores[j].acquisitions,
+					(unsigned long long)s_.stores[j].contended,
+					(unsigned long long)s_.stores[j].hold_ns);
+			fprintf(fp_, "\n");
+		}
+
+		// one line, one object
+		inline void print_json(FILE* fp_, const snapshot& s_) noexcept
+		{
+			fprintf(fp_, "{\"enabled\":%s,\"seconds\":%.6f,\"threads\":%u,\"events\":{",
+				enabled ? "true" : "false", s_.seconds, s_.threads);
+			for (unsigned e = 0; e < event_count; ++e)
+				fprintf(fp_, "%s\"%s\":%llu", e ? "," : "", event_names[e], (unsigned long long)s_.events[e]);
+			fprintf(fp_, "},\"uuid4_per_second\":%.1f,\"stores\":[", uuid4_per_second(s_));
+			for (unsigned j = 0; j < s_.store_count; ++j)
+				fprintf(fp_, "%s{\"guid\":\"%s\",\"acquisitions\":%llu,\"contended\":%llu,\"hold_ns\":%llu}",
+					j ? "," : "", s_.stores[j].guid,
+					(unsigned long long)s_.stores[j].acquisitions,
+					(unsigned long long)s_.stores[j].contended,
+					(unsigned long long)s_.stores[j].hold_ns);
+			fprintf(fp_, "]}\n");
+		}
+
+#if DBJ_INSTRUMENT
+
+		namespace details {
+
+			constexpr inline size_t cache_line = 64;
+
+			// per thread, thus single writer: relaxed load and store,
+			// no locked add; atomic only so that snapshots do not tear
+			inline void bump(std::atomic<uint64_t>& c_, uint64_t n_) noexcept
+			{
+				c_.store(c_.load(std::memory_order_relaxed) + n_, std::memory_order_relaxed);
+			}
+
+			inline uint64_t ticks() noexcept
+			{
+#ifdef DBJ_INSTRUMENT_RDTSC
+				return __rdtsc();
+#else
+				return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+			}
+
+			struct lock_counters final {
+				std::atomic<uint64_t> acquisitions{};
+				std::atomic<uint64_t> contended{};     // of the sampled ones
+				std::atomic<uint64_t> hold_ticks{};
+				std::atomic<uint64_t> hold_samples{};
+			};
+
+			// one per thread, no two threads share a cache line
+			struct alignas(cache_line) thread_counters final {
+				std::atomic<uint64_t> events[event_count]{};
+				lock_counters stores[max_stores]{};
+				thread_counters* next{};
+
+				void add_to(thread_counters& sum_) const noexcept
+				{
+					for (unsigned e = 0; e < event_count; ++e)
+						bump(sum_.events[e], events[e].load(std::memory_order_relaxed));
+					for (unsigned j = 0; j < max_stores; ++j) {
+						bump(sum_.stores[j].acquisitions, stores[j].acquisitions.load(std::memory_order_relaxed));
+						bump(sum_.stores[j].contended, stores[j].contended.load(std::memory_order_relaxed));
+						bump(sum_.stores[j].hold_ticks, stores[j].hold_ticks.load(std::memory_order_relaxed));
+						bump(sum_.stores[j].hold_samples, stores[j].hold_samples.load(std::memory_order_relaxed));
+					}
+				}
+			};
+
+			struct registry final {
+				std::mutex mx{};
+				thread_counters* live{};
+				unsigned live_count{};
+				thread_counters retired{};  // left behind by finished threads
+				char store_guids[max_stores][guid_text_size]{};
+				unsigned store_count{};
+				uint64_t start_ticks{ ticks() };
+				std::chrono::steady_clock::time_point start_time{ std::chrono::steady_clock::now() };
+
+				static registry& get() noexcept
+				{
+					static registry the_registry_{};
+					return the_registry_;
+				}
+			};
+
+			// the fast path is a plain thread local pointer, with no init guard
+			inline thread_local thread_counters* local_counters{};
+
+			struct thread_slot final {
+				thread_counters* counters{ new thread_counters{} };
+
+				thread_slot() noexcept
+				{
+					registry& r_ = registry::get();
+					std::lock_guard<std::mutex> lock_(r_.mx);
+					counters->next = r_.live;
+					r_.live = counters;
+					++r_.live_count;
+				}
+
+				~thread_slot()
+				{
+					registry& r_ = registry::get();
+					std::lock_guard<std::mutex> lock_(r_.mx);
+					counters->add_to(r_.retired);
+					for (thread_counters** p_ = &r_.live; *p_; p_ = &(*p_)->next)
+						if (*p_ == counters) { *p_ = counters->next; break; }
+					--r_.live_count;
+					delete counters;
+					// thread locals destructed after this one may still count,
+					// those go to retired; atomic thus no data race, although
+					// two threads doing it at once may lose a count
+					local_counters = &r_.retired;
+				}
+			};
+
+			inline thread_counters* attach() noexcept
+			{
+				thread_local thread_slot slot_{};
+				return slot_.counters;
+			}
+
+			inline thread_counters& local() noexcept
+			{
+				if (!local_counters) local_counters = attach();
+				return *local_counters;
+			}
+		} // details
+
+		inline void count(event e_, uint64_t n_) noexcept
+		{
+			details::bump(details::local().events[unsigned(e_)], n_);
+		}
+
+		// which store is locking, slot == max_stores is not counted
+		struct lock_site final {
+			unsigned slot{ max_stores };
+		};
+
+		// G is dbj::GUID, or anything with the same four fields
+		template <typename G>
+		inline lock_site register_store(const G& guid_) noexcept
+		{
+			char text_[guid_text_size]{};
+			snprintf(text_, sizeof(text_), "{%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X}",
+				unsigned(guid_.Data1), unsigned(guid_.Data2), unsigned(guid_.Data3),
+				guid_.Data4[0], guid_.Data4[1], guid_.Data4[2], guid_.Data4[3],
+				guid_.Data4[4], guid_.Data4[5], guid_.Data4[6], guid_.Data4[7]);
+
+			details::registry& r_ = details::registry::get();
+			std::lock_guard<std::mutex> lock_(r_.mx);
+			for (unsigned j = 0; j < r_.store_count; ++j)
+				if (strcmp(r_.store_guids[j], text_) == 0)
+					return { j };
+			if (r_.store_count == max_stores)
+				return {};
+			memcpy(r_.store_guids[r_.store_count], text_, sizeof(text_));
+			return { r_.store_count++ };
+		}
+
+		// locks M, counting the acquisition, the contention and the hold time
+		class lock_probe final {
+			details::lock_counters* counters_{};
+			uint64_t start_{};
+		public:
+			explicit lock_probe(lock_site site_) noexcept
+				: counters_(site_.slot < max_stores ? &details::local().stores[site_.slot] : nullptr) {
+			}
+
+			template <typename M>
+			void acquire(M& mutex_)
+			{
+				if (!counters_) { mutex_.lock(); return; }
+				const uint64_t n_ = counters_->acquisitions.load(std::memory_order_relaxed);
+				counters_->acquisitions.store(n_ + 1, std::memory_order_relaxed);
+				if ((n_ & (hold_sample_period - 1)) != 0) { mutex_.lock(); return; }
+
+				// sampled, is it contended and for how long is it held
+				if (!mutex_.try_lock()) {
+					details::bump(counters_->contended, 1);
+					mutex_.lock();
+				}
+				start_ = details::ticks();
+			}
+
+			template <typename M>
+			void release(M& mutex_) noexcept
+			{
+				if (start_) {
+					details::bump(counters_->hold_ticks, details::ticks() - start_);
+					details::bump(counters_->hold_samples, 1);
+					start_ = 0;
+				}
+				mutex_.unlock();
+			}
+		};
+
+		inline snapshot take_snapshot() noexcept
+		{
+			details::registry& r_ = details::registry::get();
+			details::thread_counters sum_{};
+			snapshot s_{};
+
+			std::lock_guard<std::mutex> lock_(r_.mx);
+			r_.retired.add_to(sum_);
+			for (const details::thread_counters* c_ = r_.live; c_; c_ = c_->next)
+				c_->add_to(sum_);
+
+			const auto ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - r_.start_time).count();
+			const uint64_t ticks_ = details::ticks() - r_.start_ticks;
+			const double ns_per_tick_ = ticks_ ? double(ns_) / double(ticks_) : 1.0;
+
+			s_.seconds = double(ns_) / 1e9;
+			s_.threads = r_.live_count;
+			for (unsigned e = 0; e < event_count; ++e)
+				s_.events[e] = sum_.events[e].load(std::memory_order_relaxed);
+			s_.store_count = r_.store_count;
+			for (unsigned j = 0; j < r_.store_count; ++j) {
+				memcpy(s_.stores[j].guid, r_.store_guids[j], guid_text_size);
+				s_.stores[j].acquisitions = sum_.stores[j].acquisitions.load(std::memory_order_relaxed);
+				const uint64_t samples_ = sum_.stores[j].hold_samples.load(std::memory_order_relaxed);
+				if (samples_) {
+					const double scale_ = double(s_.stores[j].acquisitions) / double(samples_);
+					s_.stores[j].contended = uint64_t(double(sum_.stores[j].contended.load(std::memory_order_relaxed)) * scale_);
+					s_.stores[j].hold_ns = uint64_t(double(sum_.stores[j].hold_ticks.load(std::memory_order_relaxed))
+						* ns_per_tick_ * scale_);
+				}
+			}
+			return s_;
+		}
+
+#else // ! DBJ_INSTRUMENT
+
+		struct lock_site final {};
+
+		template <typename G>
+		constexpr lock_site register_store(const G&) noexcept { return {}; }
+
+		// just locks
+		class lock_probe final {
+		public:
+			constexpr explicit lock_probe(lock_site) noexcept {}
+			template <typename M> void acquire(M& mutex_) { mutex_.lock(); }
+			template <typename M> void release(M& mutex_) noexcept { mutex_.unlock(); }
+		};
+
+		inline snapshot take_snapshot() noexcept { return {}; }
+
+#endif // ! DBJ_INSTRUMENT
+	} // instrument
+} // dbj
+
+namespace {
+
+	inline void test_dbj_instrument() noexcept
+	{
+		namespace di = dbj::instrument;
+
+		struct guid_like final { uint32_t Data1; uint16_t Data2; uint16_t Data3; uint8_t Data4[8]; };
+		constexpr guid_like store_id_{ 0xFE297330, 0xBAA5, 0x407F, { 0xBB, 0x47, 0xF7, 0x87, 0x52, 0xD2, 0xC2, 0x09 } };
+
+		const di::snapshot before_ = di::take_snapshot();
+
+		DBJ_INSTRUMENT_EVENT(wrapper_copy);
+		DBJ_INSTRUMENT_ADD(uuid4_generate, 64);
+
+		// anything with lock, try_lock and unlock
+		struct flag_lock final {
+			bool locked{};
+			void lock() noexcept { locked = true; }
+			bool try_lock() noexcept { return locked ? false : (locked = true); }
+			void unlock() noexcept { locked = false; }
+		} lock_{};
+
+		di::lock_probe probe_{ di::register_store(store_id_) };
+		probe_.acquire(lock_);
+		assert(lock_.locked);
+		probe_.release(lock_);
+
+		// counting from a thread local destructed after the thread's slot
+		std::thread([] {
+			struct late_counter final {
+				~late_counter() { DBJ_INSTRUMENT_EVENT(wrapper_move); }
+			};
+			thread_local late_counter late_{};
+			(void)late_;
+			DBJ_INSTRUMENT_EVENT(wrapper_move);
+			}).join();
+
+		const di::snapshot delta_ = di::delta(di::take_snapshot(), before_);
+
+		if constexpr (di::enabled) {
+			assert(delta_.events[unsigned(di::event::wrapper_copy)] >= 1);
+			assert(delta_.events[unsigned(di::event::uuid4_generate)] >= 64);
+			assert(delta_.events[unsigned(di::event::wrapper_move)] >= 2);
+			assert(delta_.store_count >= 1);
+		}
+		else {
+			assert(delta_.events[unsigned(di::event::wrapper_copy)] == 0);
+		}
+		(void)delta_;
+
+		di::print_text(stdout, di::take_snapshot());
+	}
+} // nspace
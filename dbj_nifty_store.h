@@ -9,23 +9,31 @@
 #include <mutex>
 #include <cstdlib>
 #include "dbj_guid/dbj_guid.h"
+#include "dbj_instrument.h"
 
 namespace dbj {
 
+	// locked for the lifetime of the padlock instance
+	// when instrumented, the lock_site tells which store is locking
 	struct padlock final {
 
 		using type = padlock;
 		inline static std::mutex protector_{};  // protects last_
-		using  guard = std::lock_guard<std::mutex>;
 
-		padlock() {
-			guard lock(type::protector_);
+		explicit padlock(instrument::lock_site site_ = {}) : probe_(site_) {
+			probe_.acquire(type::protector_);
 		}
+		~padlock() { probe_.release(type::protector_); }
+
+		padlock(padlock const&) = delete;
+		padlock& operator = (padlock const&) = delete;
+	private:
+		instrument::lock_probe probe_;
 	};
 
 	struct nolock final {
 		using type = nolock;
-		nolock() = default;
+		explicit nolock(instrument::lock_site = {}) noexcept {}
 	};
 
 	using guid_source = dbj::GUID(*)();
@@ -49,12 +57,21 @@ namespace dbj {
 		using value_type = T;
 		using lock_type = LOCK;
 
+		// registered once, with the GUID of this store
+		static instrument::lock_site lock_site() noexcept {
+#if DBJ_INSTRUMENT
+			static const instrument::lock_site site_ = instrument::register_store(store_id_());
+			return site_;
+#else
+			return {};
+#endif
+		}
 
 		// not before this point we use the result of the 
 		// guid_source function
 		static dbj::GUID store_guid() noexcept {
 #pragma warning(suppress: 4101)
-			LOCK guard;
+			LOCK guard{ lock_site() };
 			return store_id_();
 		}
 
@@ -63,7 +80,7 @@ namespace dbj {
 		static value_type store(const T& new_val) noexcept
 		{
 #pragma warning(suppress: 4101)
-			lock_type guard;
+			lock_type guard{ lock_site() };
 			type::last_ = new_val;
 			return type::last_;
 		};
@@ -74,7 +91,7 @@ namespace dbj {
 		// just read the stored value
 		static value_type read(void) noexcept {
 #pragma warning(suppress: 4101)
-			lock_type guard;
+			lock_type guard{ lock_site() };
 			return type::last_;
 		}
 
@@ -1,12 +1,28 @@
 
 #include "dbj_any_wrapper/dbj_any_wrapper.h"
+#include "dbj_any_wrapper/dbj_any_bag.h"
+#include "dbj_any_wrapper/dbj_any_wrapper_pmr.h"
+#include "dbj_any_wrapper/dbj_any_callable.h"
+#include "dbj_any_wrapper/dbj_any_wrapper_file.h"
 #include "dbj_nifty_store.h"
+#include "dbj_instrument.h"
+#include "dbj_guid/dbj_guid_pool.h"
+#include "dbj_guid/dbj_guid_algo.h"
+#include "dbj_guid/dbj_guid_map.h"
 
 int main() {
 
 	test_dbj_any_wrapper_range();
+	test_dbj_any_bag();
+	test_dbj_any_wrapper_pmr();
+	test_dbj_any_callable();
+	test_dbj_any_wrapper_file();
 	test_dbj_guid();
+	test_dbj_guid_pool();
+	test_dbj_guid_algo();
+	test_dbj_guid_map();
 	test_dbj_data_store();
+	test_dbj_instrument();
 }
 
 